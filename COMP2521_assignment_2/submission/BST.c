@@ -4,6 +4,7 @@
 #include <assert.h>
 #include "BST.h"
 #include "strdup.h"
+#include "instrument.h"
 //to fix compatibility issues across devices, custom_strdup from strdup.c is used
 //instead of strdup from the string.h library
 
@@ -52,7 +53,7 @@ static node rotate_left(node curr) {
 
 //creation function
 Tree create_tree(void) {
-    Tree new_Tree = malloc(sizeof(struct _Tree));
+    Tree new_Tree = counted_malloc(sizeof(struct _Tree));
     assert(new_Tree);
     new_Tree->head = NULL;
     return new_Tree;
@@ -67,7 +68,7 @@ static void recursive_display_in_order(node curr, FILE* output);
 
 //header function for internal recursive version
 void display_in_order(Tree t) {
-    FILE* output = fopen("invertedIndex.txt","w");
+    FILE* output = counted_fopen("invertedIndex.txt","w");
     assert(output);
     recursive_display_in_order(t->head,output);
     fclose(output);
@@ -103,10 +104,10 @@ url_node return_list(Tree t, char* word) {
 //return the linked list of urls that contain this word
 static url_node recursive_return_list(node curr, char* word) {
     if (curr == NULL) return NULL;
-    if (strcmp(word,curr->word) == 0) {
+    if (counted_strcmp(word,curr->word) == 0) {
         return curr->head;
     }
-    if (strcmp(word,curr->word) > 0) return recursive_return_list(curr->right, word);
+    if (counted_strcmp(word,curr->word) > 0) return recursive_return_list(curr->right, word);
     else return recursive_return_list(curr->left, word);
 }
 
@@ -136,24 +137,24 @@ static node recursive_insertAVL(node curr, char* word, char* url) {
     // Inserting at leaf
     if (curr == NULL) return create_node(word,url);
     // Update url list
-    if (strcmp(word,curr->word) == 0) {
+    if (counted_strcmp(word,curr->word) == 0) {
         insert_url(curr,url);
         return curr;
     }
     // Inserting into the right subtree
-    if (strcmp(word,curr->word) > 0) curr->right = recursive_insertAVL(curr->right, word, url);
+    if (counted_strcmp(word,curr->word) > 0) curr->right = recursive_insertAVL(curr->right, word, url);
     // Inserting into the left subtree
-    else if (strcmp(word,curr->word) < 0) curr->left = recursive_insertAVL(curr->left, word, url);
+    else if (counted_strcmp(word,curr->word) < 0) curr->left = recursive_insertAVL(curr->left, word, url);
     update_height(curr);
     //this section takes care of the rebalancing
     if (height(curr->left) - height(curr->right) > 1) {
-        if (strcmp(word, curr->left->word) > 0) {
+        if (counted_strcmp(word, curr->left->word) > 0) {
             curr->left = rotate_left(curr->left);
         }
         curr = rotate_right(curr);							
     }
     if (height(curr->right) - height(curr->left) > 1) {
-        if (strcmp(word, curr->right->word) < 0) {
+        if (counted_strcmp(word, curr->right->word) < 0) {
             curr->right = rotate_right(curr->right);
         }
         curr = rotate_left(curr);
@@ -163,7 +164,7 @@ static node recursive_insertAVL(node curr, char* word, char* url) {
 
 //create the new node
 static node create_node(char* word, char* url) {
-    node new_node = malloc(sizeof(struct _node));
+    node new_node = counted_malloc(sizeof(struct _node));
     assert(new_node);
     new_node->left = NULL;
     new_node->right = NULL;
@@ -179,15 +180,15 @@ static void insert_url(node parent, char* url) {
     url_node curr = parent->head;
     if (curr == NULL) {
         parent->head = create_url_node(url);
-    } else if(strcmp(curr->url,url) == 0) {
+    } else if(counted_strcmp(curr->url,url) == 0) {
         return;
     } else {
         //move to point of insertion
-        while (curr->next != NULL && strcmp(url,curr->next->url) > 0) {		
+        while (curr->next != NULL && counted_strcmp(url,curr->next->url) > 0) {		
             curr = curr->next;
         }
         //if the url being inserted is already in the list, do nothing
-        if (curr->next && strcmp(url,curr->next->url) == 0) return;			
+        if (curr->next && counted_strcmp(url,curr->next->url) == 0) return;			
         url_node new_node = create_url_node(url);
         new_node->next = curr->next;
         curr->next = new_node;
@@ -196,7 +197,7 @@ static void insert_url(node parent, char* url) {
 
 //create a url node to contain url string
 static url_node create_url_node(char* url) {
-    url_node new_node = malloc(sizeof(struct _url_node));
+    url_node new_node = counted_malloc(sizeof(struct _url_node));
     assert(new_node);
     new_node->next = NULL;
     new_node->url = custom_strdup(url);
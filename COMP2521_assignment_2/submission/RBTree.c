@@ -4,6 +4,7 @@
 #include <assert.h>
 #include "RBTree.h"
 #include "strdup.h"
+#include "instrument.h"
 
 // Generic functions that can be applied to both variations of RBTrees
 URL new_url_node(char *url);
@@ -27,7 +28,7 @@ void free_group_nodes(RBTree tree);
 // Allocate memory for a RBTree_rep structure
 Tree_Rep new_RBTree(void)
 {
-    Tree_Rep new = malloc(sizeof (struct RBTree_rep));
+    Tree_Rep new = counted_malloc(sizeof (struct RBTree_rep));
     assert (new != NULL);
     new->root = NULL;
     new->size = 0;
@@ -37,7 +38,7 @@ Tree_Rep new_RBTree(void)
 // New URL node that will be stored as a linked list within a RBTree node
 URL new_url_node(char *url)
 {
-    URL new = malloc(sizeof(struct url_list));
+    URL new = counted_malloc(sizeof(struct url_list));
     assert(new != NULL);
     new->terms = 1;
     new->url = custom_strdup(url);
@@ -51,7 +52,7 @@ URL new_url_node(char *url)
 // that being one that uses the tfidf value to store a group number.
 RBTree RBTree_new_node(double tfidf, URL url)
 {
-    RBTree new = malloc(sizeof(struct node));
+    RBTree new = counted_malloc(sizeof(struct node));
     assert(new != NULL);
     new->tfidf = tfidf;
     if (url != NULL)
@@ -166,7 +167,7 @@ URL insert_url_list(URL head, URL new)
     }
 
     // Check if prepending to the URL list
-    if (strcmp(new->url, head->url) < 0)
+    if (counted_strcmp(new->url, head->url) < 0)
     {
         new->next = head;
         return new;
@@ -185,7 +186,7 @@ URL insert_url_list(URL head, URL new)
     // based of lexical order
     while (curr->next != NULL)
     {
-        if (strcmp(new->url, curr->next->url) < 0)
+        if (counted_strcmp(new->url, curr->next->url) < 0)
         {
             new->next = curr->next;
             curr->next = new;
@@ -310,7 +311,7 @@ RBTree insert_node_url(RBTree tree, double tfidf, URL url)
     }
     // Once an insertion has occurred, continuing moving up the tree until a black node is identified
     // Insertion has occurred to the left of this tree
-    else if (strcmp(url->url, retrieve_url(tree)) < 0)
+    else if (counted_strcmp(url->url, retrieve_url(tree)) < 0)
     {
         tree->left = insert_node_url(tree->left, tfidf, url);
         if (tree->colour == RED)
@@ -332,7 +333,7 @@ RBTree insert_node_url(RBTree tree, double tfidf, URL url)
                 else
                 {
                     // There are two cases to consider, if the value was inserted to either the left of the left child, or to its right
-                    // First case, strcmp(url->url, retrieve_url(tree->left)) < 0
+                    // First case, counted_strcmp(url->url, retrieve_url(tree->left)) < 0
                     // Perform a right rotation such that the child node is now the parent of the original parent and the grandchild node
                     return RBTree_right_rotation(tree);
                 }
@@ -344,7 +345,7 @@ RBTree insert_node_url(RBTree tree, double tfidf, URL url)
                 {
                     return red_children(tree);
                 }
-                // Next case, strcmp(url->url, retrieve_url(tree->left)) > 0
+                // Next case, counted_strcmp(url->url, retrieve_url(tree->left)) > 0
                 // Perform two rotations, a left rotation and then a right rotation to get the grandchild node to the parent node
                 return RBTree_LR_rotation(tree);
             }
@@ -352,7 +353,7 @@ RBTree insert_node_url(RBTree tree, double tfidf, URL url)
         }
     }
     // Insertion has occured to the right of the tree
-    else if (strcmp(url->url, retrieve_url(tree)) > 0)
+    else if (counted_strcmp(url->url, retrieve_url(tree)) > 0)
     {
         tree->right = insert_node_url(tree->right, tfidf, url);
         if (tree->colour == RED)
@@ -373,7 +374,7 @@ RBTree insert_node_url(RBTree tree, double tfidf, URL url)
                 }
                 // The left child is not a red node
                 // There are two cases to consider, if the value was inserted to the right of the right child or to its left
-                // First case, strcmp(url->url, retrieve_url(tree->right)) > 0 
+                // First case, counted_strcmp(url->url, retrieve_url(tree->right)) > 0 
                 // Perform a left rotation such that the child node is now the parent of the original parent and the grandchild node
                 return RBTree_left_rotation(tree);
             }
@@ -384,7 +385,7 @@ RBTree insert_node_url(RBTree tree, double tfidf, URL url)
                 {
                     return red_children(tree);
                 }
-                // Next case, strcmp(url->url, retrieve_url(tree->right)) < 0
+                // Next case, counted_strcmp(url->url, retrieve_url(tree->right)) < 0
                 // Perform two rotations, a right rotation followed by a left rotation to get the grandchild node to the parent position
                 return RBTree_RL_rotation(tree);
             }
@@ -575,11 +576,11 @@ RBTree RBTree_search_url(RBTree tree, char *url)
     {
         return NULL;
     }
-    else if (strcmp(url, retrieve_url(tree)) == 0)
+    else if (counted_strcmp(url, retrieve_url(tree)) == 0)
     {
         return tree;
     }
-    else if (strcmp(url, retrieve_url(tree)) < 0)
+    else if (counted_strcmp(url, retrieve_url(tree)) < 0)
     {
         return RBTree_search_url(tree->left, url);
     }
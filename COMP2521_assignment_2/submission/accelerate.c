@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include "graph.h"
+#include "kernel.h"
+#include "accelerate.h"
+
+//Extrapolation accelerated Pagerank
+//the iteration x(k+1) = teleport + M x(k) shrinks the error along every eigenvector of M at the
+//rate of its eigenvalue, so with damping close to 1 the slowest directions need hundreds of steps
+//every EXTRAPOLATION_PERIOD iterations the error is assumed to lie along one (Aitken) or two
+//(quadratic) directions and the limit those directions lead to is computed directly
+//history[0] is the newest iterate, history[1] the one before it and so on
+
+
+
+//helper functions//
+
+
+//Aitken delta-squared on every component of the last three iterates, written over the newest one
+static void aitken(double** history, int size) {
+    double* x2 = history[0];
+    double* x1 = history[1];
+    double* x0 = history[2];
+    for (int i = 0; i < size; i++) {
+        double step = x2[i] - x1[i];
+        double curve = x2[i] - 2*x1[i] + x0[i];
+        //components that are not changing geometrically are left alone
+        if (fabs(curve) < 1e-300) continue;
+        double value = x2[i] - step*step/curve;
+        if (isfinite(value) && value > 0) x2[i] = value;
+    }
+}
+
+//quadratic extrapolation from the last four iterates, written over the newest one
+//the differences y1, y2, y3 of the iterates are fitted by y3 + g1*y2 + g0*y1 = 0 in the least
+//squares sense, and the limit is (x3 + g1*x2 + g0*x1) / (1 + g1 + g0)
+//returns 0, leaving the iterate alone, if the fit is degenerate
+static int quadratic(double** history, int size) {
+    double* x3 = history[0];
+    double* x2 = history[1];
+    double* x1 = history[2];
+    double* x0 = history[3];
+    double a = 0, b = 0, c = 0, r2 = 0, r1 = 0;
+    for (int i = 0; i < size; i++) {
+        double y1 = x1[i] - x0[i];
+        double y2 = x2[i] - x1[i];
+        double y3 = x3[i] - x2[i];
+        a += y2*y2;
+        b += y2*y1;
+        c += y1*y1;
+        r2 += y2*y3;
+        r1 += y1*y3;
+    }
+    double det = a*c - b*b;
+    if (fabs(det) < 1e-300) return 0;
+    double g1 = (-r2*c + r1*b)/det;
+    double g0 = (-r1*a + r2*b)/det;
+    double scale = 1 + g1 + g0;
+    if (fabs(scale) < 1e-12) return 0;
+    for (int i = 0; i < size; i++) {
+        x3[i] = (x3[i] + g1*x2[i] + g0*x1[i])/scale;
+    }
+    return 1;
+}
+
+
+
+//calculate the Pagerank of every vertex with the Jacobi iteration, periodically extrapolating
+double* accelerated_weights(graph G, double damping_factor, double min_diff, int max_iterations,
+                            enum extrapolation method, FILE* trace, int* iterations) {
+    int size = G->nV;
+    int needed = method == EXTRAPOLATE_QUADRATIC ? 4 : 3;
+    double* history[4];
+    for (int i = 0; i < 4; i++) {
+        history[i] = malloc(sizeof(double) * (size > 0 ? size : 1));
+        assert(history[i]);
+    }
+    double* saved = malloc(sizeof(double) * (size > 0 ? size : 1));
+    assert(saved);
+    for (int i = 0; i < size; i++) history[0][i] = 1.0/size;
+
+    double* scaled = scale_weights(G, damping_factor);
+    pull_kernel pull = select_pull_kernel();
+    double teleport = (1-damping_factor)/size;
+
+    int filled = 1;                 //number of valid iterates in history
+    int checking = 0;               //set on the iteration after an extrapolation
+    double last_residual = INFINITY;
+    int count = 0;
+    while (count < max_iterations) {
+        // The oldest buffer becomes the newest iterate
+        double* next = history[3];
+        memmove(history + 1, history, sizeof(double*) * 3);
+        history[0] = next;
+        double diff = pull(G, scaled, teleport, history[1], history[0], 0, size);
+        count++;
+        if (filled < 4) filled++;
+
+        if (checking && diff > last_residual) {
+            // The extrapolation made things worse: go back to the iterate it replaced and stop extrapolating
+            if (trace) fprintf(trace, "%d %.10e rejected\n", count, diff);
+            memcpy(history[0], saved, sizeof(double) * size);
+            filled = 1;
+            checking = 0;
+            method = EXTRAPOLATE_NONE;
+            continue;
+        }
+        checking = 0;
+        if (diff < min_diff) {
+            if (trace) fprintf(trace, "%d %.10e\n", count, diff);
+            break;
+        }
+        last_residual = diff;
+
+        char* note = "";
+        if (method != EXTRAPOLATE_NONE && filled >= needed && count % EXTRAPOLATION_PERIOD == 0) {
+            memcpy(saved, history[0], sizeof(double) * size);
+            int applied = 1;
+            if (method == EXTRAPOLATE_AITKEN) aitken(history, size);
+            else applied = quadratic(history, size);
+            if (applied) {
+                // Older iterates do not belong to the same sequence as the extrapolated one
+                note = " extrapolated";
+                filled = 1;
+                checking = 1;
+            }
+        }
+        if (trace) fprintf(trace, "%d %.10e%s\n", count, diff, note);
+    }
+
+    *iterations = count;
+    double* result = history[0];
+    for (int i = 1; i < 4; i++) free(history[i]);
+    free(saved);
+    free(scaled);
+    return result;
+}
@@ -0,0 +1,26 @@
+#ifndef ACCELERATE_H
+#define ACCELERATE_H
+
+#include <stdio.h>
+#include "graph.h"
+
+//the extrapolation applied to the history of rank vectors
+enum extrapolation {
+    EXTRAPOLATE_NONE,           //plain Jacobi iteration
+    EXTRAPOLATE_AITKEN,         //Aitken delta-squared on each component, from the last three iterates
+    EXTRAPOLATE_QUADRATIC       //quadratic (minimal polynomial) extrapolation from the last four iterates
+};
+
+//number of plain iterations between two extrapolations
+#define EXTRAPOLATION_PERIOD 10
+
+//calculate the Pagerank of every vertex with the Jacobi iteration, periodically replacing the
+//current iterate by an extrapolation of the recent ones
+//an extrapolation is undone, and no more are tried, if the residual of the iteration after it is
+//larger than the residual before it
+//when trace is not NULL one line per iteration is written to it: the iteration number, its residual
+//(the L1 change of the rank vector) and whether the iteration was extrapolated or rejected
+double* accelerated_weights(graph G, double damping_factor, double min_diff, int max_iterations,
+                            enum extrapolation method, FILE* trace, int* iterations);
+
+#endif
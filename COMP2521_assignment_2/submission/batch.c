@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include "graph.h"
+#include "batch.h"
+
+//damping factors updated together, in registers
+#define GROUP 4
+
+//Batched Pagerank over several damping factors
+//the ranks are stored vertex by vertex, rank[v*width + c] for damping factor c, so the ranks of a
+//source for every damping factor share a cache line and each in-edge is loaded from memory once per
+//iteration for all of them
+//every update adds damping*weight*rank in the same order as pull_scalar, so each damping factor gets
+//the ranks a separate run with the scalar kernel would; a separate run may use the AVX2 kernel from
+//select_pull_kernel instead, which rounds differently, so the two agree to within the convergence
+//tolerance rather than exactly
+//a damping factor that has converged is copied into both buffers and its ranks are no longer stored
+
+
+
+//calculate the Pagerank of every vertex for each of 'count' damping factors at once
+double** batched_weights(graph G, double* dampings, int count, double min_diff, int max_iterations, int* iterations) {
+    assert(count > 0 && count <= MAX_DAMPINGS);
+    int size = G->nV;
+    //rows are padded to whole groups, the padding has a damping factor of 0 and is never stored
+    int width = (count + GROUP - 1) / GROUP * GROUP;
+    long cells = (long)(size > 0 ? size : 1) * width;
+    double* old_rank = malloc(sizeof(double) * cells);
+    double* new_rank = malloc(sizeof(double) * cells);
+    assert(old_rank && new_rank);
+    for (long i = 0; i < cells; i++) old_rank[i] = new_rank[i] = 1.0/size;
+
+    double damping[MAX_DAMPINGS] = {0};
+    double teleport[MAX_DAMPINGS] = {0};
+    int live[MAX_DAMPINGS] = {0};
+    int n_live = count;
+    for (int c = 0; c < count; c++) {
+        damping[c] = dampings[c];
+        teleport[c] = (1-dampings[c])/size;
+        live[c] = 1;
+        iterations[c] = max_iterations;
+    }
+
+    int iteration = 0;
+    while (iteration < max_iterations && n_live > 0) {
+        double diff[MAX_DAMPINGS] = {0};
+        for (int vert = 0; vert < size; vert++) {
+            double* old = old_rank + (long)vert*width;
+            double* new = new_rank + (long)vert*width;
+            // Every damping factor of a group is updated, four fixed sums stay in registers, and the
+            // in-edges of the vertex are still in cache for the next group
+            for (int g = 0; g < width; g += GROUP) {
+                double r0 = teleport[g], r1 = teleport[g+1], r2 = teleport[g+2], r3 = teleport[g+3];
+                for (int e = G->in_start[vert]; e < G->in_start[vert+1]; e++) {
+                    double weight = G->in_weight[e];
+                    double* source = old_rank + (long)G->in_src[e]*width + g;
+                    r0 += damping[g]*weight*source[0];
+                    r1 += damping[g+1]*weight*source[1];
+                    r2 += damping[g+2]*weight*source[2];
+                    r3 += damping[g+3]*weight*source[3];
+                }
+                double rank[GROUP] = {r0, r1, r2, r3};
+                // but only the ranks of the live ones are stored
+                for (int k = 0; k < GROUP; k++) {
+                    if (!live[g+k]) continue;
+                    new[g+k] = rank[k];
+                    diff[g+k] += fabs(old[g+k]-rank[k]);
+                }
+            }
+        }
+        iteration++;
+
+        // Retire the damping factors that have converged, keeping their ranks in both buffers
+        for (int c = 0; c < count; c++) {
+            if (live[c] && diff[c] < min_diff) {
+                live[c] = 0;
+                n_live--;
+                iterations[c] = iteration;
+                for (int v = 0; v < size; v++) old_rank[(long)v*width + c] = new_rank[(long)v*width + c];
+            }
+        }
+
+        double* temp = old_rank;
+        old_rank = new_rank;
+        new_rank = temp;
+    }
+
+    // old_rank now holds the latest ranks of every damping factor
+    double** ranks = malloc(sizeof(double*) * count);
+    assert(ranks);
+    for (int c = 0; c < count; c++) {
+        ranks[c] = malloc(sizeof(double) * (size > 0 ? size : 1));
+        assert(ranks[c]);
+        for (int v = 0; v < size; v++) ranks[c][v] = old_rank[(long)v*width + c];
+    }
+    free(old_rank);
+    free(new_rank);
+    return ranks;
+}
@@ -0,0 +1,16 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "graph.h"
+
+//the most damping factors one batched run can take
+#define MAX_DAMPINGS 16
+
+//calculate the Pagerank of every vertex for each of 'count' damping factors at once
+//the ranks of all the damping factors are kept side by side, so every iteration is one pass over the
+//in-edges; each damping factor stops being updated once its own L1 diff is below min_diff, exactly
+//as generate_weights would stop, and iterations[c] is set to the iterations damping factor c took
+//returns one rank vector per damping factor
+double** batched_weights(graph G, double* dampings, int count, double min_diff, int max_iterations, int* iterations);
+
+#endif
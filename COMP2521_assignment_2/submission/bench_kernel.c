@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <time.h>
+#include "graph.h"
+#include "kernel.h"
+#include "packed.h"
+#include "single.h"
+
+//Microbenchmark for the Pagerank pull kernels
+//builds a random graph with a skewed in-degree, then times one full update of every vertex using
+//the loop generate_weights used before the kernels (damping applied per edge, separate diff pass),
+//the scalar kernel, where supported the AVX2 kernel, the single precision kernel and the kernel over
+//packed in-edges (whose size is printed as bytes per edge)
+//build: gcc -O2 -o bench_kernel bench_kernel.c kernel.c single.c packed.c graph.c intern.c instrument.c -lm
+//usage: ./bench_kernel [vertices] [edges per vertex] [repetitions]
+
+#define DAMPING 0.85
+
+//seconds on the monotonic clock
+static double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+//build a weighted random graph, destinations are biased towards low vertex IDs
+static graph random_graph(int size, int degree) {
+    graph G = create_graph(size);
+    char name[32];
+    for (int i = 0; i < size; i++) {
+        sprintf(name, "url%d", i);
+        add_vertex(G, name);
+    }
+    char to[32];
+    for (int i = 0; i < size; i++) {
+        sprintf(name, "url%d", i);
+        for (int k = 0; k < degree; k++) {
+            double r = (double)rand() / RAND_MAX;
+            sprintf(to, "url%d", (int)(size * r * r * r));
+            add_edge(G, name, to);
+        }
+    }
+    count_links(G);
+    caclulate_weights(G);
+    return G;
+}
+
+//the update loop from generate_weights before the pull kernels were introduced
+static double pull_original(graph G, double* old_rank, double* new_rank) {
+    int size = G->nV;
+    for (int vert = 0; vert < size; vert++) {
+        new_rank[vert] = (1-DAMPING)/size;
+        for (int e = G->in_start[vert]; e < G->in_start[vert+1]; e++) {
+            new_rank[vert] += DAMPING*G->in_weight[e]*old_rank[G->in_src[e]];
+        }
+    }
+    double diff = 0;
+    for (int i = 0; i < size; i++) diff += fabs(old_rank[i]-new_rank[i]);
+    return diff;
+}
+
+//print the time per update and per edge
+static void report(char* name, graph G, double seconds, int reps, double diff) {
+    printf("%-10s %10.3f ms/iteration %8.3f ns/edge (diff %.10f)\n",
+           name, seconds * 1e3 / reps, seconds * 1e9 / ((double)reps * G->nE), diff);
+}
+
+int main(int argc, char** argv) {
+    int size = argc > 1 ? atoi(argv[1]) : 200000;
+    int degree = argc > 2 ? atoi(argv[2]) : 16;
+    int reps = argc > 3 ? atoi(argv[3]) : 50;
+
+    srand(2521);
+    graph G = random_graph(size, degree);
+    printf("%d vertices, %d edges, %d repetitions\n", G->nV, G->nE, reps);
+
+    double* old_rank = malloc(sizeof(double) * size);
+    double* new_rank = malloc(sizeof(double) * size);
+    assert(old_rank && new_rank);
+    for (int i = 0; i < size; i++) old_rank[i] = 1.0/size;
+    double* scaled = scale_weights(G, DAMPING);
+    double teleport = (1-DAMPING)/size;
+
+    double diff = 0;
+    double start = now();
+    for (int r = 0; r < reps; r++) diff = pull_original(G, old_rank, new_rank);
+    report("original", G, now() - start, reps, diff);
+
+    start = now();
+    for (int r = 0; r < reps; r++) diff = pull_scalar(G, scaled, teleport, old_rank, new_rank, 0, size);
+    report("scalar", G, now() - start, reps, diff);
+
+    if (select_pull_kernel() == pull_avx2) {
+        start = now();
+        for (int r = 0; r < reps; r++) diff = pull_avx2(G, scaled, teleport, old_rank, new_rank, 0, size);
+        report("avx2", G, now() - start, reps, diff);
+    } else {
+        printf("avx2       not supported on this CPU\n");
+    }
+
+    float* scaled_float = malloc(sizeof(float) * (G->nE > 0 ? G->nE : 1));
+    float* old_float = malloc(sizeof(float) * size);
+    float* new_float = malloc(sizeof(float) * size);
+    assert(scaled_float && old_float && new_float);
+    for (int e = 0; e < G->nE; e++) scaled_float[e] = scaled[e];
+    for (int i = 0; i < size; i++) old_float[i] = 1.0f/size;
+    pull_float_kernel pull_float = select_pull_float_kernel();
+    start = now();
+    for (int r = 0; r < reps; r++) diff = pull_float(G, scaled_float, teleport, old_float, new_float, 0, size);
+    report(pull_float == pull_float_avx2 ? "float avx2" : "float", G, now() - start, reps, diff);
+    free(scaled_float);
+    free(old_float);
+    free(new_float);
+
+    packed_graph P = pack_graph(G);
+    double* source_ranks = malloc(sizeof(double) * size);
+    assert(source_ranks);
+    printf("packed     %10.3f bytes/edge (%d bytes unpacked)\n",
+           (double)P->start[size] / G->nE, (int)(sizeof(int) + sizeof(double)));
+    start = now();
+    for (int r = 0; r < reps; r++) diff = pull_packed(P, DAMPING, old_rank, new_rank, source_ranks);
+    report("packed", G, now() - start, reps, diff);
+    free(source_ranks);
+    drop_packed_graph(P);
+
+    free(scaled);
+    free(old_rank);
+    free(new_rank);
+    drop_graph(G);
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "graph.h"
+#include "kernel.h"
+#include "loader.h"
+#include "ranking.h"
+#include "instrument.h"
+
+//Benchmark driver for pagerank
+//runs the stages of pagerank on the collection in the current directory (see gen_graph.c) and times
+//each one: load (collection.txt and the url files), weights (compressing the graph and weighting the
+//edges), iterate, and write (sorting the weights and writing pagerankList.txt with write_ranking, as
+//pagerank does)
+//prints one JSON object on stdout with the time of every stage and its throughput in edges per second
+//(edge visits for iterate), so runs can be collected and compared for regressions
+//build: gcc -O2 -pthread -o bench_pagerank bench_pagerank.c kernel.c loader.c ranking.c graph.c intern.c instrument.c
+//       threads.c read_data.c strdup.c -lm
+//usage: ./bench_pagerank [damping factor] [min_diff] [max_iterations] [threads]
+
+#define STAGES 4
+
+int main(int argc, char** argv) {
+    double damping_factor = argc > 1 ? atof(argv[1]) : 0.85;
+    double min_diff = argc > 2 ? atof(argv[2]) : 0.00001;
+    int max_iterations = argc > 3 ? atoi(argv[3]) : 1000;
+    int threads = argc > 4 ? atoi(argv[4]) : 1;
+
+    char* names[STAGES] = {"load", "weights", "iterate", "write"};
+    double seconds[STAGES];
+    int iterations = 0;
+
+    double start = instrument_now();
+    graph G = load_graph(threads);
+    seconds[0] = instrument_now() - start;
+
+    start = instrument_now();
+    count_links(G);
+    caclulate_weights(G);
+    seconds[1] = instrument_now() - start;
+
+    start = instrument_now();
+    double* weights = generate_weights(G, damping_factor, min_diff, max_iterations, &iterations);
+    seconds[2] = instrument_now() - start;
+
+    start = instrument_now();
+    write_ranking(G, weights, G->nV, "pagerankList.txt");
+    seconds[3] = instrument_now() - start;
+
+    // Every stage but iterate touches each edge about once
+    double edges[STAGES] = {G->nE, G->nE, (double)G->nE * iterations, G->nE};
+    double total = 0;
+    for (int s = 0; s < STAGES; s++) total += seconds[s];
+    printf("{\"benchmark\": \"pagerank\", \"pages\": %d, \"edges\": %d, \"threads\": %d, \"iterations\": %d, ",
+           G->nV, G->nE, threads, iterations);
+    printf("\"seconds\": {");
+    for (int s = 0; s < STAGES; s++) printf("\"%s\": %.6f, ", names[s], seconds[s]);
+    printf("\"total\": %.6f}, \"edges_per_second\": {", total);
+    for (int s = 0; s < STAGES; s++) {
+        printf("\"%s\": %.0f%s", names[s], seconds[s] > 0 ? edges[s] / seconds[s] : 0, s < STAGES - 1 ? ", " : "");
+    }
+    printf("}}\n");
+
+    free(weights);
+    drop_graph(G);
+    return 0;
+}
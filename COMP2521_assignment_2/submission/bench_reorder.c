@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "graph.h"
+#include "kernel.h"
+#include "reorder.h"
+
+//Benchmark for the vertex orders in reorder.c
+//builds a graph of small link communities whose vertex IDs are shuffled (as urls in collection.txt
+//usually are), then times full pull updates and counts last level cache misses with the vertices in
+//the given order, by degree and in reverse Cuthill-McKee order
+//cache misses come from perf_event_open and are reported as unavailable where it is not permitted
+//build: gcc -O2 -o bench_reorder bench_reorder.c reorder.c kernel.c graph.c intern.c instrument.c -lm
+//usage: ./bench_reorder [vertices] [edges per vertex] [repetitions]
+
+#define DAMPING 0.85
+#define COMMUNITY 64
+
+//seconds on the monotonic clock
+static double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+//open a counter of cache misses for this process, or return -1
+static int open_cache_counter(void) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+//build a weighted graph of communities, most edges stay inside their community, vertex IDs are shuffled
+static graph community_graph(int size, int degree) {
+    int* label = malloc(sizeof(int) * size);
+    assert(label);
+    for (int i = 0; i < size; i++) label[i] = i;
+    for (int i = size - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int temp = label[i];
+        label[i] = label[j];
+        label[j] = temp;
+    }
+
+    graph G = create_graph(size);
+    char name[32];
+    for (int i = 0; i < size; i++) {
+        sprintf(name, "url%d", i);
+        add_vertex(G, name);
+    }
+    for (int i = 0; i < size; i++) {
+        int base = i - i % COMMUNITY;
+        for (int k = 0; k < degree; k++) {
+            int to = rand() % 8 == 0 ? rand() % size : base + rand() % COMMUNITY;
+            if (to < size) add_edge_by_ID(G, label[i], label[to]);
+        }
+    }
+    free(label);
+    count_links(G);
+    caclulate_weights(G);
+    return G;
+}
+
+//time 'reps' pull updates of G and print them with the cache misses they caused
+static void run(char* name, graph G, int reps, int counter) {
+    int size = G->nV;
+    double* old_rank = malloc(sizeof(double) * size);
+    double* new_rank = malloc(sizeof(double) * size);
+    assert(old_rank && new_rank);
+    for (int i = 0; i < size; i++) old_rank[i] = 1.0/size;
+    double* scaled = scale_weights(G, DAMPING);
+    double teleport = (1-DAMPING)/size;
+
+    if (counter != -1) {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    double start = now();
+    for (int r = 0; r < reps; r++) pull_scalar(G, scaled, teleport, old_rank, new_rank, 0, size);
+    double seconds = now() - start;
+    long long misses = -1;
+    if (counter != -1) {
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(counter, &misses, sizeof(misses)) != sizeof(misses)) misses = -1;
+    }
+
+    printf("%-10s %10.3f ms/iteration %8.3f ns/edge", name, seconds * 1e3 / reps, seconds * 1e9 / ((double)reps * G->nE));
+    if (misses >= 0) printf(" %10.3f cache misses/edge\n", (double)misses / ((double)reps * G->nE));
+    else printf("   cache misses unavailable\n");
+    free(scaled);
+    free(old_rank);
+    free(new_rank);
+}
+
+int main(int argc, char** argv) {
+    int size = argc > 1 ? atoi(argv[1]) : 1000000;
+    int degree = argc > 2 ? atoi(argv[2]) : 8;
+    int reps = argc > 3 ? atoi(argv[3]) : 20;
+
+    srand(2521);
+    graph G = community_graph(size, degree);
+    printf("%d vertices, %d edges, %d repetitions\n", G->nV, G->nE, reps);
+    int counter = open_cache_counter();
+
+    run("original", G, reps, counter);
+
+    char* names[] = {"degree", "rcm"};
+    enum vertex_order methods[] = {ORDER_DEGREE, ORDER_RCM};
+    for (int m = 0; m < 2; m++) {
+        double start = now();
+        int* order = vertex_order(G, methods[m]);
+        reorder_graph(G, order, NULL);
+        printf("%-10s reordered in %.3f ms\n", names[m], (now() - start) * 1e3);
+        run(names[m], G, reps, counter);
+        restore_order(G, order, NULL);
+        free(order);
+    }
+
+    if (counter != -1) close(counter);
+    drop_graph(G);
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "graph.h"
+#include "kernel.h"
+#include "ranking.h"
+#include "BST.h"
+#include "read_data.h"
+#include "instrument.h"
+
+//This program builds both outputs of the search engine in one run: pagerankList.txt, as pagerank
+//writes it, and invertedIndex.txt, as inverted writes it
+//every url file is read once with read_document, its links become the edges of the graph and its
+//distinct words are added to the inverted index tree, where pagerank and inverted each read every file
+//build: gcc -O2 -o buildIndex buildIndex.c read_data.c graph.c intern.c kernel.c ranking.c BST.c strdup.c
+//       instrument.c -lm
+
+
+//read every url file once, adding its links to G and its words to t
+void read_documents(graph G, Tree t);
+
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        fprintf(stderr,"Usage: %s [damping factor] [min_diff] [max_iterations]\n",argv[0]);
+        abort();
+    }
+    start_instrument(argv[0]);
+    double damping_factor = atof(argv[1]);
+    double min_diff = atof(argv[2]);
+    int max_iterations = atoi(argv[3]);
+
+    // Read the urls from collection.txt, then the links and words of each of them
+    struct stage_timer timer = start_stage("read");
+    Rep list = read_collection();
+    graph G = create_graph(list->size);
+    for (int i = 0; i < list->size; i++) {
+        add_vertex(G,list->items[i].str);
+    }
+    free_rep(list);
+    Tree t = create_tree();
+    read_documents(G, t);
+    stop_stage(timer);
+
+    // Weight the graph and compute the weighted pagerank for each url
+    timer = start_stage("solve");
+    count_links(G);
+    caclulate_weights(G);
+    int iterations = 0;
+    double* weights = generate_weights(G, damping_factor, min_diff, max_iterations, &iterations);
+    stop_stage(timer);
+
+    timer = start_stage("write");
+    write_ranking(G, weights, G->nV, "pagerankList.txt");
+    display_in_order(t);
+    stop_stage(timer);
+
+    free(weights);
+    drop_graph(G);
+    drop_tree(t);
+    return 0;
+}
+
+//read every url file once, adding its links to G and its words to t
+void read_documents(graph G, Tree t) {
+    for (int i = 0; i < G->nV; i++) {
+        char* url = G->map[i];
+        Document doc = read_document(url);
+        for (int l = 0; l < doc->file->n_links; l++) {
+            add_edge(G,url,doc->file->links[l].str);
+        }
+        //each distinct word is inserted once, the tree only records which urls contain it
+        for (int w = 0; w < doc->n_terms; w++) {
+            insertAVL(t,doc->terms[w].str,url);
+        }
+        free_document(doc);
+    }
+}
@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "graph.h"
+#include "kernel.h"
+#include "checkpoint.h"
+
+//Checkpointed Pagerank
+//the solver and the writer thread share two buffers: the solver copies the ranks into the spare one
+//and hands it over, the writer writes it out while the solver carries on with its own vectors
+//a checkpoint that comes due while the previous one is still being written is put off to the next
+//iteration rather than waited for
+
+
+
+//the state shared with the writer thread
+struct writer {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    struct checkpoint_header header;
+    double* ranks;              //the copy being written
+    int busy;                   //set while a checkpoint is waiting to be or being written
+    int stop;
+    char* file;
+    char* temporary;
+};
+
+
+
+//helper functions//
+
+
+//write the checkpoint held by the writer to its temporary file and move it over the real one
+static void write_checkpoint(struct writer* w) {
+    FILE* output = fopen(w->temporary, "wb");
+    if (output == NULL) {
+        fprintf(stderr, "Unable to write checkpoint %s\n", w->temporary);
+        return;
+    }
+    int ok = fwrite(&w->header, sizeof(w->header), 1, output) == 1;
+    ok = ok && fwrite(w->ranks, sizeof(double), w->header.nV, output) == (size_t)w->header.nV;
+    ok = fclose(output) == 0 && ok;
+    if (!ok || rename(w->temporary, w->file) != 0) {
+        fprintf(stderr, "Unable to write checkpoint %s\n", w->file);
+        remove(w->temporary);
+    }
+}
+
+//entry point of the writer thread: write every checkpoint handed over until told to stop
+static void* writer_main(void* data) {
+    struct writer* w = data;
+    pthread_mutex_lock(&w->lock);
+    while (1) {
+        while (!w->busy && !w->stop) pthread_cond_wait(&w->changed, &w->lock);
+        if (!w->busy) break;
+        //the solver does not touch the copy while busy is set, so it is written without the lock
+        pthread_mutex_unlock(&w->lock);
+        write_checkpoint(w);
+        pthread_mutex_lock(&w->lock);
+        w->busy = 0;
+        pthread_cond_broadcast(&w->changed);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+//hand a copy of the ranks to the writer, returning 0 if it is still busy with the previous checkpoint
+static int hand_over(struct writer* w, double* rank, int iterations) {
+    pthread_mutex_lock(&w->lock);
+    int free_to_write = !w->busy;
+    if (free_to_write) {
+        memcpy(w->ranks, rank, sizeof(double) * w->header.nV);
+        w->header.iterations = iterations;
+        w->busy = 1;
+        pthread_cond_broadcast(&w->changed);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return free_to_write;
+}
+
+//FNV-1a hash of the urls and the in-links of G in its current vertex order, so that a checkpoint is
+//only resumed on the same graph with its vertices numbered the same way
+static unsigned long long graph_hash(graph G) {
+    unsigned long long hash = 14695981039346656037ull;
+    for (int i = 0; i < G->nV; i++) {
+        for (unsigned char* c = (unsigned char*)G->map[i]; ; c++) {
+            hash = (hash ^ *c) * 1099511628211ull;
+            if (*c == '\0') break;
+        }
+    }
+    for (int i = 0; i <= G->nV; i++) hash = (hash ^ (unsigned)G->in_start[i]) * 1099511628211ull;
+    for (int e = 0; e < G->nE; e++) hash = (hash ^ (unsigned)G->in_src[e]) * 1099511628211ull;
+    return hash;
+}
+
+//read the checkpoint in 'file' into rank, returning the iterations it was taken after or -1 if there
+//is no checkpoint; a checkpoint which does not match 'expected' (another graph, vertex order or damping
+//factor) is refused rather than used to seed the wrong vertices
+static int read_checkpoint(graph G, struct checkpoint_header* expected, char* file, double* rank) {
+    FILE* input = fopen(file, "rb");
+    if (input == NULL) return -1;
+    struct checkpoint_header header;
+    if (fread(&header, sizeof(header), 1, input) != 1 ||
+        memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0) {
+        fclose(input);
+        return -1;
+    }
+    if (header.order != expected->order) {
+        fprintf(stderr, "Checkpoint %s was written with a different --reorder, resume with the same one\n", file);
+        abort();
+    }
+    if (header.nV != expected->nV || header.nE != expected->nE || header.graph_hash != expected->graph_hash ||
+        header.damping_factor != expected->damping_factor) {
+        fprintf(stderr, "Checkpoint %s is of another graph or damping factor\n", file);
+        abort();
+    }
+    int iterations = fread(rank, sizeof(double), G->nV, input) == (size_t)G->nV ? header.iterations : -1;
+    fclose(input);
+    return iterations;
+}
+
+
+
+//iterate like generate_weights, writing a checkpoint to 'file' every 'period' iterations
+double* checkpointed_weights(graph G, double damping_factor, double min_diff, int max_iterations,
+                             char* file, int period, int resume, enum vertex_order order, int* iterations) {
+    int size = G->nV;
+    double* new_rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    double* old_rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    assert(new_rank && old_rank);
+
+    struct writer w;
+    memset(&w.header, 0, sizeof(w.header));
+    memcpy(w.header.magic, CHECKPOINT_MAGIC, sizeof(w.header.magic));
+    w.header.nV = size;
+    w.header.nE = G->nE;
+    w.header.order = order;
+    w.header.damping_factor = damping_factor;
+    w.header.graph_hash = graph_hash(G);
+
+    int count = resume ? read_checkpoint(G, &w.header, file, old_rank) : -1;
+    if (count == -1) {
+        if (resume) fprintf(stderr, "No checkpoint in %s, starting from uniform ranks\n", file);
+        count = 0;
+        for (int i = 0; i < size; i++) old_rank[i] = 1.0/size;
+    }
+    for (int i = 0; i < size; i++) new_rank[i] = old_rank[i];
+
+    w.ranks = malloc(sizeof(double) * (size > 0 ? size : 1));
+    w.temporary = malloc(strlen(file) + 5);
+    assert(w.ranks && w.temporary);
+    sprintf(w.temporary, "%s.tmp", file);
+    w.file = file;
+    w.busy = 0;
+    w.stop = 0;
+    pthread_mutex_init(&w.lock, NULL);
+    pthread_cond_init(&w.changed, NULL);
+    if (pthread_create(&w.thread, NULL, writer_main, &w) != 0) {
+        fprintf(stderr, "Unable to start the checkpoint writer\n");
+        abort();
+    }
+
+    double* scaled = scale_weights(G, damping_factor);
+    pull_kernel pull = select_pull_kernel();
+    int due = count + period;
+    while (count < max_iterations) {
+        double diff = pull(G, scaled, (1-damping_factor)/size, old_rank, new_rank, 0, size);
+        count++;
+        if (diff < min_diff || count == max_iterations) break;
+        double* temp = old_rank;
+        old_rank = new_rank;
+        new_rank = temp;
+        if (count >= due && hand_over(&w, old_rank, count)) due = count + period;
+    }
+
+    // Let the last checkpoint finish
+    pthread_mutex_lock(&w.lock);
+    w.stop = 1;
+    pthread_cond_broadcast(&w.changed);
+    pthread_mutex_unlock(&w.lock);
+    pthread_join(w.thread, NULL);
+    pthread_mutex_destroy(&w.lock);
+    pthread_cond_destroy(&w.changed);
+
+    *iterations = count;
+    free(w.ranks);
+    free(w.temporary);
+    free(scaled);
+    free(old_rank);
+    return new_rank;
+}
@@ -0,0 +1,33 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "graph.h"
+#include "reorder.h"
+
+//first bytes of a checkpoint file
+#define CHECKPOINT_MAGIC "PRCHECK2"
+
+//header of a checkpoint file, followed by double rank[nV] in vertex order
+//the file uses the byte order and type sizes of the machine that wrote it
+struct checkpoint_header {
+    char magic[8];
+    int nV;
+    int nE;
+    int iterations;
+    int order;                      //the --reorder method (enum vertex_order) the vertices were in
+    double damping_factor;
+    unsigned long long graph_hash;  //hash of the urls and in-links in that vertex order
+};
+
+//iterate like generate_weights, writing the ranks and iteration count to 'file' every 'period'
+//iterations; the file is written by a second thread from its own copy of the ranks, to a temporary
+//file that then replaces 'file', so iterations do not wait for the disk and a run killed while
+//writing leaves the previous checkpoint intact
+//if 'resume' is set and 'file' holds a checkpoint, the iteration continues from it (max_iterations
+//counts the iterations it already made); a checkpoint of another graph, vertex order or damping factor
+//is refused, G must have been renumbered by 'order' as it was for the run that wrote it
+//the total number of iterations is stored in *iterations
+double* checkpointed_weights(graph G, double damping_factor, double min_diff, int max_iterations,
+                             char* file, int period, int resume, enum vertex_order order, int* iterations);
+
+#endif
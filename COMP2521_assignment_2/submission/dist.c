@@ -5,6 +5,7 @@
 #include <math.h>
 #include "dist.h"
 #include "strdup.h"
+#include "instrument.h"
 //to fix compatibility issues across devices, custom_strdup from strdup.c is used
 //instead of strdup from the string.h library
 
@@ -61,7 +62,7 @@ data gen_tree(int argc, char** argv) {
     assert(argc > 1);
 	char buffer[MAX_WORD_SIZE];
 	// create and intialize an array indicating size of sets (rank lists)
-	int* set_sizes = malloc(sizeof(int)*(argc - 1));
+	int* set_sizes = counted_malloc(sizeof(int)*(argc - 1));
 	assert(set_sizes);
 	for (int i = 0; i < argc - 1; set_sizes[i++] = 0);
 	//create a intialize the tree used to perform cost calculations
@@ -70,14 +71,14 @@ data gen_tree(int argc, char** argv) {
 	t->no_sets = argc - 1;
 	//open every file provided on by user, and read ranked items into tree, noting their position and the set they are in
 	for (int set = 0; set < argc - 1; set++) {
-		FILE* input = fopen(argv[set + 1],"r");
+		FILE* input = counted_fopen(argv[set + 1],"r");
 		assert(input);
 		int position = 1;
 		while (fscanf(input,"%s",buffer) == 1) {
 			insertAVL(t,buffer,set,position++);
 			t->set_sizes[set]++;
 		}
-		fclose(input);
+		counted_fclose(input);
 	}
 	//return an array of pointers to nodes in the tree in order
 	t->node_arr = return_array(t);
@@ -103,13 +104,13 @@ double W(Tree t, int c, int p) {
 //their names, and the the cost of putting the cth elements in position p, indexed in the array as arr[c][p] where c and p are
 //0-indexed
 data return_data(Tree t) {
-    data object = malloc(sizeof(struct _data));
+    data object = counted_malloc(sizeof(struct _data));
     assert(object);
     //malloc memory for and populate the cost array
-    double** arr = malloc(sizeof(double*)*(t->no_elements));
+    double** arr = counted_malloc(sizeof(double*)*(t->no_elements));
     assert(arr);
     for (int i = 0; i < t->no_elements; i++) {
-        arr[i] = malloc(sizeof(double)*(t->no_elements));
+        arr[i] = counted_malloc(sizeof(double)*(t->no_elements));
         assert(arr[i]);
         for (int j = 0; j < t->no_elements; j++) {
         	//need to call with j+1 as the W function expectes the position to be 1 - indexed
@@ -117,7 +118,7 @@ data return_data(Tree t) {
         }
     }
     //malloc and initialize the names array
-    char** names = malloc(sizeof(char*)*(t->no_elements));
+    char** names = counted_malloc(sizeof(char*)*(t->no_elements));
     assert(names);
     for (int i = 0; i < t->no_elements; i++) {
         names[i] = custom_strdup(t->node_arr[i]->word);
@@ -204,7 +205,7 @@ static node rotate_left(node curr) {
 
 //creation function
 static Tree create_tree(void) {
-    Tree new_Tree = malloc(sizeof(struct _Tree));
+    Tree new_Tree = counted_malloc(sizeof(struct _Tree));
     assert(new_Tree);
     new_Tree->head = NULL;
     new_Tree->no_elements = 0;
@@ -225,7 +226,7 @@ static void recursive_return_array(node curr, node* arr, int* index);
 
 //header function for internal recursive version
 static node* return_array(Tree t) {
-    node* arr = malloc(sizeof(node)*t->no_elements);
+    node* arr = counted_malloc(sizeof(node)*t->no_elements);
     assert(arr);
     int index = 0;
     //pass in a pointer to index which is incremented every time we add an
@@ -273,24 +274,24 @@ static node recursive_insertAVL(Tree t, node curr, char* word, int set, int posi
         return create_node(word,set,position);
     }
     //Update set list
-    if (strcmp(word,curr->word) == 0) {
+    if (counted_strcmp(word,curr->word) == 0) {
         insert_set(curr,set,position);
         return curr;
     }
     // Inserting into the right subtree
-    if (strcmp(word,curr->word) > 0) curr->right = recursive_insertAVL(t, curr->right, word, set, position);
+    if (counted_strcmp(word,curr->word) > 0) curr->right = recursive_insertAVL(t, curr->right, word, set, position);
     // Inserting into the left subtree
-    else if (strcmp(word,curr->word) < 0) curr->left = recursive_insertAVL(t, curr->left, word, set, position);
+    else if (counted_strcmp(word,curr->word) < 0) curr->left = recursive_insertAVL(t, curr->left, word, set, position);
     update_height(curr);
     //this section takes care of the rebalancing
     if (height(curr->left) - height(curr->right) > 1) {
-        if (strcmp(word, curr->left->word) > 0) {
+        if (counted_strcmp(word, curr->left->word) > 0) {
             curr->left = rotate_left(curr->left);
         }
         curr = rotate_right(curr);
     }
     if (height(curr->right) - height(curr->left) > 1) {
-        if (strcmp(word, curr->right->word) < 0) {
+        if (counted_strcmp(word, curr->right->word) < 0) {
             curr->right = rotate_right(curr->right);
         }
         curr = rotate_left(curr);
@@ -300,7 +301,7 @@ static node recursive_insertAVL(Tree t, node curr, char* word, int set, int posi
 
 //create the new node
 static node create_node(char* word, int set, int position) {
-    node new_node = malloc(sizeof(struct _node));
+    node new_node = counted_malloc(sizeof(struct _node));
     assert(new_node);
     new_node->left = NULL;
     new_node->right = NULL;
@@ -320,7 +321,7 @@ static void insert_set(node parent, int set, int position) {
 
 //create a url node to contain url string				    
 static set_node create_set_node(int set, int position) {
-    set_node new_node = malloc(sizeof(struct _set_node));
+    set_node new_node = counted_malloc(sizeof(struct _set_node));
     assert(new_node);
     new_node->next = NULL;
     new_node-> set = set;
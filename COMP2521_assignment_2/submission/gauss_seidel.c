@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "graph.h"
+#include "kernel.h"
+#include "gauss_seidel.h"
+
+//Gauss-Seidel Pagerank
+//a single rank vector is updated in place so rank mass reaches a vertex in the same sweep that its
+//sources are updated, rather than one iteration later
+//sweeping in forward order (sources first) lets mass travel along whole chains in one sweep and
+//solves acyclic parts of the graph exactly in a single pass
+//the fixed point is the same as the Jacobi iteration in generate_weights, the stopping rule is the same
+//L1 change of the rank vector over one sweep
+
+
+
+//helper functions//
+
+
+//visit every vertex reachable from 'start' that has not been queued yet, appending them to the order
+static void breadth_first(graph G, int start, int* order, int* length, char* queued) {
+    if (queued[start]) return;
+    int head = *length;
+    order[(*length)++] = start;
+    queued[start] = 1;
+    while (head < *length) {
+        int vert = order[head++];
+        for (int e = G->out_start[vert]; e < G->out_start[vert+1]; e++) {
+            int dest = G->out_dest[e];
+            if (!queued[dest]) {
+                queued[dest] = 1;
+                order[(*length)++] = dest;
+            }
+        }
+    }
+}
+
+
+
+//return an order to sweep the vertices in which sources tend to come before the vertices they link to
+int* forward_order(graph G) {
+    int* order = malloc(sizeof(int) * (G->nV > 0 ? G->nV : 1));
+    char* queued = calloc(G->nV > 0 ? G->nV : 1, sizeof(char));
+    assert(order && queued);
+    int length = 0;
+
+    // Start from vertices nothing links to, then pick up any cycles they do not reach
+    for (int v = 0; v < G->nV; v++) {
+        if (G->links[v].links_in == 0) breadth_first(G, v, order, &length, queued);
+    }
+    for (int v = 0; v < G->nV; v++) breadth_first(G, v, order, &length, queued);
+
+    free(queued);
+    return order;
+}
+
+//calculate the Pagerank of every vertex in place
+double* gauss_seidel_weights(graph G, double damping_factor, double min_diff, int max_iterations, int* iterations) {
+    int size = G->nV;
+    double* rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    assert(rank);
+    for (int i = 0; i < size; i++) rank[i] = 1.0/size;
+
+    double* scaled = scale_weights(G, damping_factor);
+    int* order = forward_order(G);
+    double teleport = (1-damping_factor)/size;
+
+    int count = 0;
+    while (count < max_iterations) {
+        double diff = 0;
+        for (int i = 0; i < size; i++) {
+            int vert = order[i];
+            double value = teleport;
+            for (int e = G->in_start[vert]; e < G->in_start[vert+1]; e++) {
+                value += scaled[e]*rank[G->in_src[e]];
+            }
+            diff += fabs(rank[vert]-value);
+            rank[vert] = value;
+        }
+        count++;
+        if (diff < min_diff) break;
+    }
+
+    *iterations = count;
+    free(order);
+    free(scaled);
+    return rank;
+}
@@ -0,0 +1,14 @@
+#ifndef GAUSS_SEIDEL_H
+#define GAUSS_SEIDEL_H
+
+#include "graph.h"
+
+//return an order to sweep the vertices in which sources tend to come before the vertices they
+//link to, found by a breadth first search along out-edges that starts from vertices without in-links
+int* forward_order(graph G);
+
+//calculate the Pagerank of every vertex in place, each update using the ranks already updated in
+//the same sweep, and store the number of sweeps made in *iterations
+double* gauss_seidel_weights(graph G, double damping_factor, double min_diff, int max_iterations, int* iterations);
+
+#endif
@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <sys/stat.h>
+
+//Synthetic web graph generator
+//writes collection.txt and a urlN.txt for every page into a directory, in the format the search
+//engine reads: the links of the page in Section-1 and a few words of text in Section-2
+//  rmat      links pick a quadrant of the adjacency matrix recursively (a, b, c, d = 0.57, 0.19,
+//            0.19, 0.05), which gives the skewed degrees and communities of a real crawl
+//  powerlaw  every page gets a Pareto distributed number of links to pages picked with a Zipf like
+//            popularity, popular pages spread over the ID range
+//the output only depends on the arguments, so the same graph can be generated again
+//build: gcc -O2 -o gen_graph gen_graph.c -lm
+//usage: ./gen_graph [pages] [links per page] [rmat|powerlaw] [directory] [seed]
+
+#define WORDS_PER_PAGE 12
+#define VOCABULARY 64
+
+static char* vocabulary[VOCABULARY] = {
+    "mars", "moon", "planet", "orbit", "surface", "water", "ice", "dust", "storm", "rover",
+    "probe", "launch", "rocket", "engine", "fuel", "crew", "station", "solar", "wind", "energy",
+    "light", "telescope", "image", "camera", "signal", "radio", "antenna", "data", "science", "study",
+    "mission", "landing", "crater", "volcano", "valley", "river", "ocean", "atmosphere", "pressure", "heat",
+    "cold", "night", "day", "season", "year", "time", "distance", "gravity", "mass", "speed",
+    "earth", "sun", "star", "galaxy", "comet", "asteroid", "meteor", "ring", "gas", "rock",
+    "soil", "life", "human", "design"
+};
+
+
+
+//helper functions//
+
+
+//a uniform random number in [0, 1) from a 64 bit xorshift generator
+static unsigned long long state = 88172645463325292ull;
+static double uniform(void) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return (state >> 11) * (1.0 / 9007199254740992.0);
+}
+
+//the target of an R-MAT edge from 'from' in a graph of 2^scale pages, or -1 if it falls outside 'pages'
+static int rmat_target(int scale, int pages, int* from) {
+    int row = 0;
+    int column = 0;
+    for (int level = 0; level < scale; level++) {
+        double r = uniform();
+        int bit = 1 << (scale - 1 - level);
+        //quadrant a (r < 0.57) keeps both bits clear
+        if (r >= 0.57 && r < 0.76) column |= bit;
+        if (r >= 0.76) row |= bit;
+        if (r >= 0.95) column |= bit;
+    }
+    *from = row;
+    return row < pages && column < pages ? column : -1;
+}
+
+//append an int to a growable list
+static void append(int** list, int* size, int* cap, int value) {
+    if (*size == *cap) {
+        *cap = *cap > 0 ? *cap * 2 : 4;
+        *list = realloc(*list, sizeof(int) * *cap);
+        assert(*list);
+    }
+    (*list)[(*size)++] = value;
+}
+
+
+
+int main(int argc, char** argv) {
+    int pages = argc > 1 ? atoi(argv[1]) : 1000;
+    int degree = argc > 2 ? atoi(argv[2]) : 8;
+    char* model = argc > 3 ? argv[3] : "rmat";
+    char* directory = argc > 4 ? argv[4] : ".";
+    state += argc > 5 ? strtoull(argv[5], NULL, 10) * 0x9E3779B97F4A7C15ull : 0;
+    if (pages < 1 || degree < 0 || (strcmp(model, "rmat") != 0 && strcmp(model, "powerlaw") != 0)) {
+        fprintf(stderr, "usage: %s [pages] [links per page] [rmat|powerlaw] [directory] [seed]\n", argv[0]);
+        return 1;
+    }
+    mkdir(directory, 0755);
+
+    // Collect the links of every page
+    int** links = calloc(pages, sizeof(int*));
+    int* size = calloc(pages, sizeof(int));
+    int* cap = calloc(pages, sizeof(int));
+    assert(links && size && cap);
+    long edges = (long)pages * degree;
+    if (strcmp(model, "rmat") == 0) {
+        int scale = 0;
+        while ((1L << scale) < pages) scale++;
+        for (long e = 0; e < edges; e++) {
+            int from = 0;
+            int to = rmat_target(scale, pages, &from);
+            if (to == -1) {
+                e--;
+                continue;
+            }
+            if (from != to) append(&links[from], &size[from], &cap[from], to);
+        }
+    } else {
+        //a fixed shuffle spreads the popular pages over the IDs
+        int* popular = malloc(sizeof(int) * pages);
+        assert(popular);
+        for (int i = 0; i < pages; i++) popular[i] = i;
+        for (int i = pages - 1; i > 0; i--) {
+            int j = uniform() * (i + 1);
+            int temp = popular[i];
+            popular[i] = popular[j];
+            popular[j] = temp;
+        }
+        for (int from = 0; from < pages; from++) {
+            //Pareto with shape 2 and the requested mean
+            int count = degree / 2.0 / sqrt(1 - uniform());
+            if (count > pages - 1) count = pages - 1;
+            for (int k = 0; k < count; k++) {
+                int to = popular[(int)(pages * pow(uniform(), 3))];
+                if (to != from) append(&links[from], &size[from], &cap[from], to);
+            }
+        }
+        free(popular);
+    }
+
+    // collection.txt lists every url, a few to a line
+    char* name = malloc(strlen(directory) + 32);
+    assert(name);
+    sprintf(name, "%s/collection.txt", directory);
+    FILE* collection = fopen(name, "w");
+    if (collection == NULL) {
+        fprintf(stderr, "Unable to write %s\n", name);
+        return 1;
+    }
+    for (int i = 0; i < pages; i++) fprintf(collection, "url%d%s", i, i % 8 == 7 || i == pages - 1 ? "\n" : " ");
+    fclose(collection);
+
+    // One url file per page
+    long written = 0;
+    for (int i = 0; i < pages; i++) {
+        sprintf(name, "%s/url%d.txt", directory, i);
+        FILE* output = fopen(name, "w");
+        if (output == NULL) {
+            fprintf(stderr, "Unable to write %s\n", name);
+            return 1;
+        }
+        fprintf(output, "#start Section-1\n\n");
+        for (int k = 0; k < size[i]; k++) fprintf(output, "url%d%s", links[i][k], k % 8 == 7 ? "\n" : " ");
+        fprintf(output, "\n\n#end Section-1\n\n#start Section-2\n\n");
+        for (int k = 0; k < WORDS_PER_PAGE; k++) {
+            fprintf(output, "%s%s", vocabulary[(int)(VOCABULARY * pow(uniform(), 2))], k % 6 == 5 ? ".\n" : " ");
+        }
+        fprintf(output, "\n#end Section-2\n");
+        fclose(output);
+        written += size[i];
+        free(links[i]);
+    }
+    printf("%d pages, %ld links written to %s\n", pages, written, directory);
+
+    free(name);
+    free(links);
+    free(size);
+    free(cap);
+    return 0;
+}
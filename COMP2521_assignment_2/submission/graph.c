@@ -2,13 +2,17 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
-#include "strdup.h"
+#include <sys/mman.h>
 #include "graph.h"
 
+#define EMPTY_KEY (~0ull)
+
 //Michael Ellis z5215441 10/10/18
-//This is an implementation of an adjacency matrix representation for graphs
+//This is an implementation of a compressed sparse row representation for graphs
+//edges are collected as (from, to) pairs by add_edge and compressed once, when the graph is first
+//processed, into a row layout (out-edges) and its transpose (in-edges) so memory is O(V+E)
 //the graph has a 'map' field which relates the indexes of vertices in the graph to 
-//a string representing the name of the url
+//a string representing the name of the url, the reverse lookup goes through an intern table
 
 
 
@@ -17,11 +21,9 @@
 
 //convert a name to an integer ID
 static int name_to_ID(graph G, char* name) {
-    for (int i = 0; i < G->nV; i++) {
-        if (strcmp(G->map[i],name) == 0) return i;
-    }
-    abort();
-    return -1;				//return an invalid vertex index
+    int id = vertex_ID(G, name);
+    if (id == -1) abort();
+    return id;
 }
 
 //check vertices are valid
@@ -29,6 +31,90 @@ static int validV(graph G, int vertex) {
     return (G != NULL && vertex >= 0 && vertex < G->nV);
 }
 
+//order vertex IDs in ascending order
+static int compare_IDs(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+//insert an edge into the edge set, returning 0 if it was already there
+static int insert_edge_key(graph G, int from, int to) {
+    unsigned long long key = ((unsigned long long)from << 32) | (unsigned)to;
+    int mask = G->edge_set_cap - 1;
+    int slot = (int)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (G->edge_set[slot] != EMPTY_KEY) {
+        if (G->edge_set[slot] == key) return 0;
+        slot = (slot + 1) & mask;
+    }
+    G->edge_set[slot] = key;
+    return 1;
+}
+
+//double the size of the edge set, rehashing the pending edges
+static void grow_edge_set(graph G) {
+    free(G->edge_set);
+    G->edge_set_cap *= 2;
+    G->edge_set = malloc(sizeof(unsigned long long) * G->edge_set_cap);
+    assert(G->edge_set);
+    for (int i = 0; i < G->edge_set_cap; i++) G->edge_set[i] = EMPTY_KEY;
+    for (int e = 0; e < G->n_pending; e++) insert_edge_key(G, G->pending[e].from, G->pending[e].to);
+}
+
+//build the row and column arrays from the pending edges
+static void compress_graph(graph G) {
+    if (G->out_start != NULL) return;
+
+    int nE = G->n_pending;
+    G->nE = nE;
+    G->out_start = malloc(sizeof(int) * (G->nV + 1));
+    G->in_start = malloc(sizeof(int) * (G->nV + 1));
+    G->out_dest = malloc(sizeof(int) * (nE > 0 ? nE : 1));
+    G->in_src = malloc(sizeof(int) * (nE > 0 ? nE : 1));
+    int* cursor = malloc(sizeof(int) * (G->nV > 0 ? G->nV : 1));
+    assert(G->out_start && G->in_start && G->out_dest && G->in_src && cursor);
+
+    // The link counts kept by add_edge give the starting offset of every row and column
+    G->out_start[0] = G->in_start[0] = 0;
+    for (int v = 0; v < G->nV; v++) {
+        G->out_start[v+1] = G->out_start[v] + G->links[v].links_out;
+        G->in_start[v+1] = G->in_start[v] + G->links[v].links_in;
+    }
+
+    // Place each edge in its row, then order every row by destination
+    memcpy(cursor, G->out_start, sizeof(int) * G->nV);
+    for (int e = 0; e < nE; e++) {
+        G->out_dest[cursor[G->pending[e].from]++] = G->pending[e].to;
+    }
+    for (int v = 0; v < G->nV; v++) {
+        qsort(G->out_dest + G->out_start[v], G->out_start[v+1] - G->out_start[v], sizeof(int), compare_IDs);
+    }
+
+    // Walking the rows in order lists the sources of every column in ascending order
+    memcpy(cursor, G->in_start, sizeof(int) * G->nV);
+    for (int v = 0; v < G->nV; v++) {
+        for (int e = G->out_start[v]; e < G->out_start[v+1]; e++) {
+            G->in_src[cursor[G->out_dest[e]]++] = v;
+        }
+    }
+    free(cursor);
+
+    free(G->pending);
+    free(G->edge_set);
+    G->pending = NULL;
+    G->edge_set = NULL;
+    G->n_pending = G->pending_cap = G->edge_set_cap = 0;
+}
+
+//weight of the edge from -> to, given the in-link and out-link sums over the destinations of 'from'
+double edge_weight(graph G, double* sum_I, double* sum_O, int from, int to) {
+    double I_j = G->links[to].links_in;
+    double O_j = G->links[to].links_out > 0 ? G->links[to].links_out : 0.5;
+    double W_in = I_j/sum_I[from];
+    double W_out = O_j/sum_O[from];
+    return W_in * W_out;
+}
+
 
 
 //creation functions//
@@ -39,20 +125,31 @@ graph create_graph(int size) {
     graph G = malloc(sizeof(struct _graph));
     assert(G);
     G->nV = size;
-
-	// Allocate memory for the adjacency matrix
-    G->arr = malloc(sizeof(double*)*size);
-    assert(G->arr);
-    for(int i = 0; i < size; i++) {
-        G->arr[i] = malloc(sizeof(double)*size);
-        assert(G->arr[i]);
-        for(int j = 0; j < size; j++) G->arr[i][j] = 0;
-    }
+    G->nE = 0;
+
+	// Edges are buffered until the graph is compressed
+    G->pending_cap = 16;
+    G->n_pending = 0;
+    G->pending = malloc(sizeof(struct edge) * G->pending_cap);
+    G->edge_set_cap = 32;
+    G->edge_set = malloc(sizeof(unsigned long long) * G->edge_set_cap);
+    assert(G->pending && G->edge_set);
+    for (int i = 0; i < G->edge_set_cap; i++) G->edge_set[i] = EMPTY_KEY;
+    G->out_start = G->out_dest = NULL;
+    G->in_start = G->in_src = NULL;
+    G->out_weight = G->in_weight = NULL;
+    G->stamps = NULL;
+    G->snapshot = NULL;
+    G->snapshot_size = 0;
 
 	// Allocate memory for an array of strings that is used to map indexes to URL names
     G->map = malloc(sizeof(char*) *size);
     assert(G->map);
     for(int i = 0; i < size; i++) G->map[i] = NULL;
+    G->names = create_intern_table(size);
+    G->vertex_of = malloc(sizeof(int) * (size > 0 ? size : 1));
+    assert(G->vertex_of);
+    G->n_mapped = 0;
 
 	//  Create an array of structs that stores the value of in weights and out weights
     G->links = malloc(sizeof(struct info) * size);
@@ -67,27 +164,54 @@ graph create_graph(int size) {
 
 //add a vertex to the map field
 void add_vertex(graph G, char* name) {
-    int index = 0;
-    while (G->map[index] != NULL) {
-        index++;
-        if (index == G->nV) {
-            fprintf(stderr,"Too many vertices added\n");
-            abort();
-        }
+    if (G->n_mapped == G->nV) {
+        fprintf(stderr,"Too many vertices added\n");
+        abort();
     }
-    G->map[index] = custom_strdup(name);
+    //a repeated name shares the string of its first occurrence and edges resolve to that vertex
+    int interned = G->names->size;
+    int id = intern(G->names, name);
+    if (G->names->size > interned) G->vertex_of[id] = G->n_mapped;
+    G->map[G->n_mapped++] = intern_name(G->names, id);
 }
 
 //add a directed edge to the graph
 void add_edge(graph G, char* from, char* to) {
-    int from_ID = name_to_ID(G, from);
-    int to_ID = name_to_ID(G, to);
+    add_edge_by_ID(G, name_to_ID(G, from), name_to_ID(G, to));
+}
+
+//add a directed edge between two vertex IDs to the graph
+void add_edge_by_ID(graph G, int from_ID, int to_ID) {
     if (from_ID == to_ID) return;						//ignore loops
     if (!(validV(G, from_ID) && validV(G,to_ID))) {
         fprintf(stderr, "Invalid vertex\n");
         abort();
     }
-    G->arr[from_ID][to_ID] = 1;
+    if (G->out_start != NULL) {
+        fprintf(stderr, "Edge added after the graph was compressed\n");
+        abort();
+    }
+    if (!insert_edge_key(G, from_ID, to_ID)) return;		//ignore repeated edges
+    if (G->n_pending == G->pending_cap) {
+        G->pending_cap *= 2;
+        G->pending = realloc(G->pending, sizeof(struct edge) * G->pending_cap);
+        assert(G->pending);
+    }
+    G->pending[G->n_pending].from = from_ID;
+    G->pending[G->n_pending].to = to_ID;
+    G->n_pending++;
+    G->links[from_ID].links_out++;
+    G->links[to_ID].links_in++;
+    // Keep the edge set at most half full
+    if (G->n_pending * 2 > G->edge_set_cap) grow_edge_set(G);
+}
+
+
+
+//return the ID of the vertex with the given name, or -1 if there is no such vertex
+int vertex_ID(graph G, char* name) {
+    int id = intern_lookup(G->names, name);
+    return id == -1 ? -1 : G->vertex_of[id];
 }
 
 
@@ -97,11 +221,11 @@ void add_edge(graph G, char* from, char* to) {
 
 //print out the structure of the graph
 void display_graph(graph G) {
-
+    compress_graph(G);
     for(int i = 0; i < G->nV; i++) {
         printf("[%s]->",G->map[i]);
-        for(int j = 0; j < G->nV; j++) {
-            if (G->arr[i][j] != 0) printf("[%s]->",G->map[j]);
+        for(int e = G->out_start[i]; e < G->out_start[i+1]; e++) {
+            printf("[%s]->",G->map[G->out_dest[e]]);
         }
         printf("[X]\n");
         //printf("links_out: %d\n",G->links[i].links_out);
@@ -116,63 +240,76 @@ void display_graph(graph G) {
 
 
 //count edges leading out and in for every vertex
+//the counts are kept up to date by add_edge, so this only finishes building the graph
 void count_links(graph G) {
-    for (int vert = 0; vert < G->nV; vert++) {
-        for (int dest = 0; dest < G->nV; dest++) {
-            if (G->arr[vert][dest] != 0) {
-            	G->links[vert].links_out++;
-            	G->links[dest].links_in++;
-            }
-        }
-    }
+    compress_graph(G);
 }
 
 //calculate edge weights
 void caclulate_weights(graph G) {
-	// Iterate through all the edges in the graph
+    compress_graph(G);
+    if (G->out_weight == NULL) {
+        G->out_weight = malloc(sizeof(double) * (G->nE > 0 ? G->nE : 1));
+        G->in_weight = malloc(sizeof(double) * (G->nE > 0 ? G->nE : 1));
+        assert(G->out_weight && G->in_weight);
+    }
+    double* sum_I = calloc(G->nV > 0 ? G->nV : 1, sizeof(double));
+    double* sum_O = calloc(G->nV > 0 ? G->nV : 1, sizeof(double));
+    assert(sum_I && sum_O);
+
+	// Sum the inlinks and outlinks of the destinations of every vertex once
+    for (int i = 0; i < G->nV; i++) {
+        for (int e = G->out_start[i]; e < G->out_start[i+1]; e++) {
+            int j = G->out_dest[e];
+            double value = G->links[j].links_out;
+            sum_I[i] += G->links[j].links_in;
+            sum_O[i] += value > 0 ? value : 0.5;
+        }
+    }
+
+    // Assign the product of W_in and W_out to every edge, in both layouts
     for (int i = 0; i < G->nV; i++) {
-        for (int j = 0; j < G->nV; j++) {
-        	// If there's no edge, continue
-            if (G->arr[i][j] == 0) continue;
-            
-            // Compute the product of weight in and weight out
-            double I_j = G->links[j].links_in;
-            double sum_I_p = 0;
-            for (int k = 0; k < G->nV; k++) {
-                if (G->arr[i][k] != 0) sum_I_p += G->links[k].links_in;
-            }
-            
-            // Calculate the sum of inlinks
-            double O_j = G->links[j].links_out > 0 ? G->links[j].links_out : 0.5;
-            double sum_O_p = 0;
-            for (int k = 0; k < G->nV; k++) {
-                if (G->arr[i][k] != 0) {
-                    double value = G->links[k].links_out;
-                    sum_O_p += value > 0 ? value : 0.5;
-                }
-            }
-            //printf("%d %d\n",i,j);
-            double W_in = I_j/sum_I_p;
-            double W_out = O_j/sum_O_p;
-
-            //printf("W_in: %.7lf\n",W_in);
-            //printf("W_out: %.7lf\n",W_out);
-            double weight = W_in * W_out;
-            
-            // Assign the weight to the edge
-            G->arr[i][j] = weight;
+        for (int e = G->out_start[i]; e < G->out_start[i+1]; e++) {
+            G->out_weight[e] = edge_weight(G, sum_I, sum_O, i, G->out_dest[e]);
+        }
+        for (int e = G->in_start[i]; e < G->in_start[i+1]; e++) {
+            G->in_weight[e] = edge_weight(G, sum_I, sum_O, G->in_src[e], i);
         }
     }
+
+    free(sum_I);
+    free(sum_O);
+}
+
+//free the edges and weights of both layouts, keeping their offsets
+void drop_edges(graph G) {
+    if (G->snapshot != NULL) return;
+    free(G->out_dest);
+    free(G->out_weight);
+    free(G->in_src);
+    free(G->in_weight);
+    G->out_dest = G->in_src = NULL;
+    G->out_weight = G->in_weight = NULL;
 }
 
 //free all memory associated with the graph
 void drop_graph(graph G) {
-    for (int i = 0; i < G->nV; i++) {
-        free(G->map[i]);
-        free(G->arr[i]);
+    drop_intern_table(G->names);
+    free(G->vertex_of);
+    free(G->pending);
+    free(G->edge_set);
+    free(G->stamps);
+    if (G->snapshot != NULL) {
+        munmap(G->snapshot, G->snapshot_size);
+    } else {
+        free(G->out_start);
+        free(G->out_dest);
+        free(G->out_weight);
+        free(G->in_start);
+        free(G->in_src);
+        free(G->in_weight);
+        free(G->links);
     }
-    free(G->links);
-    free(G->arr);
     free(G->map);
     free(G);
 }
@@ -1,16 +1,58 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include "intern.h"
+
+struct source_stamp;
+
 struct info {
     int links_in;
     int links_out;
 };
 
+//a directed edge recorded by add_edge before the graph is compressed
+struct edge {
+    int from;
+    int to;
+};
+
 typedef struct _graph {
     int nV;
+    int nE;
     struct info* links;
     char** map;
-    double** arr;
+
+    //interns url names, map[i] points at the interned name of vertex i and vertex_of
+    //gives the vertex that first used each interned name
+    intern_table names;
+    int* vertex_of;
+    int n_mapped;
+
+    //edges collected by add_edge, released once the graph is compressed
+    //edge_set holds every pending edge as (from << 32 | to) so duplicates are dropped on insertion
+    struct edge* pending;
+    int n_pending;
+    int pending_cap;
+    unsigned long long* edge_set;
+    int edge_set_cap;
+
+    //compressed sparse row: the out-edges of v are out_dest[out_start[v]] .. out_dest[out_start[v+1]-1]
+    int* out_start;
+    int* out_dest;
+    double* out_weight;         //both weight arrays stay NULL until caclulate_weights
+
+    //compressed sparse column (the transpose): the in-edges of v are in_src[in_start[v]] .. in_src[in_start[v+1]-1]
+    int* in_start;
+    int* in_src;
+    double* in_weight;
+
+    //stamps of collection.txt and then of each vertex's url file, taken as they were read (see
+    //read_data.h), in collection order; NULL unless the graph was read from the url files
+    struct source_stamp* stamps;
+
+    //set when links and the row/column arrays point into a mapped snapshot file rather than the heap
+    void* snapshot;
+    long snapshot_size;
 } *graph;
 
 //allocate memory for a graph, setting all values to 0/NULL
@@ -25,12 +67,28 @@ void add_vertex(graph G, char* name);
 //add a directed edge to the graph
 void add_edge(graph G, char* from, char* to);
 
+//add a directed edge between two vertex IDs to the graph
+void add_edge_by_ID(graph G, int from, int to);
+
+//return the ID of the vertex with the given name, or -1 if there is no such vertex
+int vertex_ID(graph G, char* name);
+
 //count edges leading out and in for every vertex
+//the counts are kept up to date by add_edge, so this only finishes building the graph
 void count_links(graph G);
 
 //calculate edge weights
 void caclulate_weights(graph G);
 
+//weight of the edge from -> to (W_in * W_out) from the link counts of G, given the sums of links_in
+//and of links_out (0.5 for a vertex with none) over the destinations of 'from'
+double edge_weight(graph G, double* sum_I, double* sum_O, int from, int to);
+
+//free the edges and weights of both layouts, keeping the names, link counts and row/column offsets
+//(enough to write a ranking); the arrays of a mapped snapshot are left in place, their pages are
+//read from the file and not swapped
+void drop_edges(graph G);
+
 //free all memory associated with the graph
 void drop_graph(graph G);
 
@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include "graph.h"
+#include "intern.h"
+#include "kernel.h"
+#include "incremental.h"
+
+//Incremental Pagerank
+//when only a few url files change between runs the previous ranks are already converged almost
+//everywhere, so after one full sweep the iteration keeps a work list of the vertices that can still
+//move: those linked to from a vertex that moved noticeably on the last sweep
+//the work of a sweep is then proportional to the region affected by the changed edges
+//a small change which is not passed on leaves its destinations stale by up to the change times the
+//scaled weights of its out-edges, these are added up over the whole run and kept within half of
+//min_diff, so that a full sweep at the point the iteration stops would move the ranks by less than
+//min_diff, as the full iteration guarantees
+//the ranks in pagerankList.txt are rounded, which by itself moves every vertex by more than the
+//work list threshold, so the exact binary rank state is the better warm start
+
+
+
+//read the ranks of a pagerankList.txt style file into rank
+static void read_rank_list(graph G, FILE* input, double* rank) {
+    char* url = NULL;
+    int links = 0;
+    double value = 0;
+    while (fscanf(input, "%ms %d, %lf", &url, &links, &value) == 3) {
+        //get rid of trailing comma
+        url[strlen(url)-1] = '\0';
+        int id = intern_lookup(G->names, url);
+        if (id != -1) rank[G->vertex_of[id]] = value;
+        free(url);
+    }
+}
+
+//read the entries of a binary rank state file (after the magic) into rank
+//each entry is the url length as an int, the url without its terminator and the rank as a double
+static void read_rank_state(graph G, FILE* input, double* rank) {
+    int count = 0;
+    if (fread(&count, sizeof(int), 1, input) != 1) return;
+    char* url = NULL;
+    int url_cap = 0;
+    for (int i = 0; i < count; i++) {
+        int length = 0;
+        double value = 0;
+        if (fread(&length, sizeof(int), 1, input) != 1 || length < 0) break;
+        if (length + 1 > url_cap) {
+            url_cap = length + 1;
+            url = realloc(url, url_cap);
+            assert(url);
+        }
+        if (fread(url, 1, length, input) != (size_t)length) break;
+        if (fread(&value, sizeof(double), 1, input) != 1) break;
+        url[length] = '\0';
+        int id = intern_lookup(G->names, url);
+        if (id != -1) rank[G->vertex_of[id]] = value;
+    }
+    free(url);
+}
+
+
+
+//read the ranks of a previous run and return a rank vector for G
+double* read_previous_ranks(graph G, char* file) {
+    FILE* input = fopen(file,"rb");
+    if (input == NULL) return NULL;
+
+    double* rank = malloc(sizeof(double) * (G->nV > 0 ? G->nV : 1));
+    assert(rank);
+    for (int i = 0; i < G->nV; i++) rank[i] = 1.0/G->nV;
+
+    char magic[sizeof(RANK_STATE_MAGIC) - 1];
+    if (fread(magic, 1, sizeof(magic), input) == sizeof(magic) && memcmp(magic, RANK_STATE_MAGIC, sizeof(magic)) == 0) {
+        read_rank_state(G, input, rank);
+    } else {
+        rewind(input);
+        read_rank_list(G, input, rank);
+    }
+    fclose(input);
+    return rank;
+}
+
+//write the rank of every vertex of G, keyed by url, to a binary rank state file
+void write_rank_state(graph G, double* rank, char* file) {
+    FILE* output = fopen(file,"wb");
+    assert(output);
+    fwrite(RANK_STATE_MAGIC, 1, sizeof(RANK_STATE_MAGIC) - 1, output);
+    fwrite(&G->nV, sizeof(int), 1, output);
+    for (int i = 0; i < G->nV; i++) {
+        int length = strlen(G->map[i]);
+        fwrite(&length, sizeof(int), 1, output);
+        fwrite(G->map[i], 1, length, output);
+        fwrite(&rank[i], sizeof(double), 1, output);
+    }
+    fclose(output);
+}
+
+//continue the Pagerank iteration from 'initial', recomputing only the vertices that may have changed
+double* incremental_weights(graph G, double damping_factor, double min_diff, int max_iterations,
+                            double* initial, int* iterations, long* updates) {
+    int size = G->nV;
+    double* rank = initial;
+    double* next = malloc(sizeof(double) * (size > 0 ? size : 1));
+    double* spread = malloc(sizeof(double) * (size > 0 ? size : 1));
+    int* active = malloc(sizeof(int) * (size > 0 ? size : 1));
+    int* next_active = malloc(sizeof(int) * (size > 0 ? size : 1));
+    int* queued = malloc(sizeof(int) * (size > 0 ? size : 1));
+    assert(next && spread && active && next_active && queued);
+
+    double* scaled = scale_weights(G, damping_factor);
+    double teleport = (1-damping_factor)/size;
+    double moved = min_diff/size;
+
+    // How much a change of one unit at a vertex moves the ranks it links to, in total
+    for (int i = 0; i < size; i++) spread[i] = 0;
+    for (int e = 0; e < G->nE; e++) spread[G->in_src[e]] += scaled[e];
+    double budget = min_diff/2;
+    double skipped = 0;
+
+    // The first sweep visits every vertex since any of them may be affected by the changed edges
+    int n_active = size;
+    for (int i = 0; i < size; i++) {
+        active[i] = i;
+        queued[i] = -1;
+    }
+
+    int count = 0;
+    long work = 0;
+    while (count < max_iterations && n_active > 0) {
+        double diff = 0;
+        for (int i = 0; i < n_active; i++) {
+            int vert = active[i];
+            double value = teleport;
+            for (int e = G->in_start[vert]; e < G->in_start[vert+1]; e++) {
+                value += scaled[e]*rank[G->in_src[e]];
+            }
+            next[vert] = value;
+            diff += fabs(rank[vert]-value);
+        }
+        work += n_active;
+        count++;
+
+        // Apply the new ranks and queue the destinations of every vertex that moved noticeably
+        int n_next = 0;
+        for (int i = 0; i < n_active; i++) {
+            int vert = active[i];
+            double change = fabs(rank[vert]-next[vert]);
+            rank[vert] = next[vert];
+            if (change <= moved && skipped + change*spread[vert] <= budget) {
+                skipped += change*spread[vert];
+                continue;
+            }
+            for (int e = G->out_start[vert]; e < G->out_start[vert+1]; e++) {
+                int dest = G->out_dest[e];
+                if (queued[dest] != count) {
+                    queued[dest] = count;
+                    next_active[n_next++] = dest;
+                }
+            }
+        }
+        int* temp = active;
+        active = next_active;
+        next_active = temp;
+        n_active = n_next;
+
+        // The vertices left out of the sweep are stale by at most what was skipped
+        if (diff + skipped < min_diff) break;
+    }
+
+    *iterations = count;
+    *updates = work;
+    free(scaled);
+    free(next);
+    free(spread);
+    free(active);
+    free(next_active);
+    free(queued);
+    return rank;
+}
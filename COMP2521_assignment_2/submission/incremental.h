@@ -0,0 +1,29 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include "graph.h"
+
+//first bytes of a binary rank state file
+#define RANK_STATE_MAGIC "PRSTATE1"
+
+//read the ranks of a previous run and return a rank vector for G, vertices missing from the file
+//start at 1.0/nV
+//the file is either a rank state written by write_rank_state, which keeps every rank exactly, or a
+//pagerankList.txt ("url, outlinks, rank" per line), whose ranks are rounded to 7 decimals
+//returns NULL if the file can not be opened
+double* read_previous_ranks(graph G, char* file);
+
+//write the rank of every vertex of G, keyed by url, to a binary rank state file
+void write_rank_state(graph G, double* rank, char* file);
+
+//continue the Pagerank iteration from 'initial' (which is taken over by this function), recomputing
+//only the vertices that may have changed: every vertex on the first sweep, then only vertices with an
+//in-link from a vertex whose rank moved by more than min_diff/nV on the sweep before, or by less while
+//the changes skipped this way could move the ranks by more than min_diff/2 in total
+//stops once the L1 change of a sweep plus the skipped changes is below min_diff, so that a full sweep
+//would move the ranks by less than min_diff, as in the full iteration
+//the number of sweeps and vertex updates made are stored in *iterations and *updates
+double* incremental_weights(graph G, double damping_factor, double min_diff, int max_iterations,
+                            double* initial, int* iterations, long* updates);
+
+#endif
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "instrument.h"
+
+//Instrumentation
+//cheap timers and counters for finding where a run spends its time without a profiler
+//with SEARCH_STATS set every binary prints one JSON object on stderr as it exits:
+//  {"program": ..., "seconds": total, "stages": {name: {"seconds": s, "calls": n}, ...},
+//   "counters": {"files_opened": n, "bytes_parsed": n, "strcmp_calls": n, "allocations": n},
+//   "peak_rss_kb": n}
+//allocations and strcmp calls are those made through counted_malloc/counted_strcmp by the
+//readers, trees and string tables, not every call in the program
+
+#define MAX_STAGES 32
+
+struct stage {
+    char* name;
+    double seconds;
+    long calls;
+};
+
+int instrument_enabled = 0;
+long instrument_counters[COUNTERS];
+
+static char* counter_names[COUNTERS] = {"files_opened", "bytes_parsed", "strcmp_calls", "allocations"};
+static char* program_name = NULL;
+static double program_start;
+static struct stage stages[MAX_STAGES];
+static int stage_count = 0;
+
+
+
+//helper functions//
+
+
+//seconds on the monotonic clock
+double instrument_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+//print the report on stderr, run at exit
+static void print_report(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    fprintf(stderr, "{\"program\": \"%s\", \"seconds\": %.6f, \"stages\": {", program_name, instrument_now() - program_start);
+    for (int s = 0; s < stage_count; s++) {
+        fprintf(stderr, "%s\"%s\": {\"seconds\": %.6f, \"calls\": %ld}", s > 0 ? ", " : "",
+                stages[s].name, stages[s].seconds, stages[s].calls);
+    }
+    fprintf(stderr, "}, \"counters\": {");
+    for (int c = 0; c < COUNTERS; c++) {
+        fprintf(stderr, "%s\"%s\": %ld", c > 0 ? ", " : "", counter_names[c], instrument_counters[c]);
+    }
+    //ru_maxrss is in kilobytes on Linux
+    fprintf(stderr, "}, \"peak_rss_kb\": %ld}\n", usage.ru_maxrss);
+}
+
+
+
+//interface functions//
+
+
+//read the environment and, if the report is enabled, print it on stderr when the program exits
+void start_instrument(char* program) {
+    char* setting = getenv(INSTRUMENT_ENV);
+    if (setting == NULL || strcmp(setting, "0") == 0) return;
+    //report the binary's name without its directory
+    char* slash = strrchr(program, '/');
+    program_name = slash ? slash + 1 : program;
+    program_start = instrument_now();
+    instrument_enabled = 1;
+    atexit(print_report);
+}
+
+//start timing the stage 'name', repeated stages of the same name add up
+struct stage_timer start_stage(char* name) {
+    struct stage_timer timer = {-1, 0};
+    if (!instrument_enabled) return timer;
+    for (timer.stage = 0; timer.stage < stage_count; timer.stage++) {
+        if (strcmp(stages[timer.stage].name, name) == 0) break;
+    }
+    if (timer.stage == stage_count) {
+        //stages past the limit are not timed
+        if (stage_count == MAX_STAGES) {
+            timer.stage = -1;
+            return timer;
+        }
+        stages[stage_count].name = name;
+        stages[stage_count].seconds = 0;
+        stages[stage_count].calls = 0;
+        stage_count++;
+    }
+    timer.start = instrument_now();
+    return timer;
+}
+
+//stop a stage timer and add the time since it started to its stage
+void stop_stage(struct stage_timer timer) {
+    if (timer.stage < 0) return;
+    stages[timer.stage].seconds += instrument_now() - timer.start;
+    stages[timer.stage].calls++;
+}
@@ -0,0 +1,86 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//name of the environment variable which turns the report on, any value but "0" enables it
+#define INSTRUMENT_ENV "SEARCH_STATS"
+
+//events counted by the shared modules
+enum counter {
+    COUNT_FILES_OPENED,
+    COUNT_BYTES_PARSED,
+    COUNT_STRCMP,
+    COUNT_ALLOCATIONS,
+    COUNTERS
+};
+
+//a running stage timer, from start_stage until stop_stage
+struct stage_timer {
+    int stage;
+    double start;
+};
+
+//set when the report is enabled, counting is skipped otherwise
+extern int instrument_enabled;
+
+//read the environment and, if the report is enabled, print it on stderr when the program exits
+//'program' names the binary in the report
+void start_instrument(char* program);
+
+//start timing the stage 'name', repeated stages of the same name add up
+//stages are timed on the main thread only, the counters may be updated from any thread
+struct stage_timer start_stage(char* name);
+
+//stop a stage timer and add the time since it started to its stage
+void stop_stage(struct stage_timer timer);
+
+//seconds on the monotonic clock, the clock the stages are timed with
+double instrument_now(void);
+
+//add 'amount' to a counter (atomic, so the url files can be read on several threads)
+static inline void count_event(enum counter c, long amount) {
+    extern long instrument_counters[COUNTERS];
+    if (instrument_enabled) __atomic_fetch_add(&instrument_counters[c], amount, __ATOMIC_RELAXED);
+}
+
+//strcmp, counting the call
+static inline int counted_strcmp(const char* a, const char* b) {
+    count_event(COUNT_STRCMP, 1);
+    return strcmp(a, b);
+}
+
+//malloc, counting the allocation
+static inline void* counted_malloc(size_t size) {
+    count_event(COUNT_ALLOCATIONS, 1);
+    return malloc(size);
+}
+
+//fopen, counting the file if it opened
+static inline FILE* counted_fopen(const char* name, const char* mode) {
+    FILE* fp = fopen(name, mode);
+    if (fp != NULL) count_event(COUNT_FILES_OPENED, 1);
+    return fp;
+}
+
+//fclose, counting the bytes read up to the current position as parsed
+static inline int counted_fclose(FILE* fp) {
+    if (instrument_enabled) {
+        long pos = ftell(fp);
+        if (pos > 0) count_event(COUNT_BYTES_PARSED, pos);
+    }
+    return fclose(fp);
+}
+
+//rewind, counting the bytes read so far as parsed
+static inline void counted_rewind(FILE* fp) {
+    if (instrument_enabled) {
+        long pos = ftell(fp);
+        if (pos > 0) count_event(COUNT_BYTES_PARSED, pos);
+    }
+    rewind(fp);
+}
+
+#endif
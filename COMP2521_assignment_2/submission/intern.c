@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "intern.h"
+#include "instrument.h"
+
+//URL intern table
+//strings are hashed once (FNV-1a) and copied into a block arena, the table itself only holds IDs
+//so lookups compare the stored hash first and call strcmp only on a hash match
+
+#define ARENA_BLOCK_SIZE 65536
+
+
+
+//helper functions//
+
+
+//FNV-1a hash of a string
+static unsigned hash_string(const char* str) {
+    unsigned hash = 2166136261u;
+    for (; *str != '\0'; str++) {
+        hash ^= (unsigned char)*str;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//copy a string into the arena and return the stable copy
+static char* arena_copy(intern_table t, const char* str) {
+    int len = strlen(str) + 1;
+    struct arena_block* block = t->arena;
+    if (block == NULL || block->size - block->used < len) {
+        int size = len > ARENA_BLOCK_SIZE ? len : ARENA_BLOCK_SIZE;
+        block = counted_malloc(sizeof(struct arena_block) + size);
+        assert(block);
+        block->used = 0;
+        block->size = size;
+        block->next = t->arena;
+        t->arena = block;
+    }
+    char* copy = block->text + block->used;
+    memcpy(copy, str, len);
+    block->used += len;
+    return copy;
+}
+
+//return the slot holding name, or the empty slot where it would be inserted
+static int find_slot(intern_table t, const char* name, unsigned hash) {
+    int mask = t->capacity - 1;
+    int slot = hash & mask;
+    while (t->slots[slot] != -1) {
+        int id = t->slots[slot];
+        if (t->hashes[id] == hash && counted_strcmp(t->names[id], name) == 0) return slot;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+//double the number of slots, reinserting every ID using its stored hash
+static void grow_slots(intern_table t) {
+    free(t->slots);
+    t->capacity *= 2;
+    t->slots = counted_malloc(sizeof(int) * t->capacity);
+    assert(t->slots);
+    for (int i = 0; i < t->capacity; i++) t->slots[i] = -1;
+    int mask = t->capacity - 1;
+    for (int id = 0; id < t->size; id++) {
+        int slot = t->hashes[id] & mask;
+        while (t->slots[slot] != -1) slot = (slot + 1) & mask;
+        t->slots[slot] = id;
+    }
+}
+
+
+
+//creation functions//
+
+
+//allocate a table sized for roughly 'expected' strings, it grows as needed
+intern_table create_intern_table(int expected) {
+    intern_table t = counted_malloc(sizeof(struct _intern_table));
+    assert(t);
+    t->size = 0;
+    t->capacity = 16;
+    while (t->capacity < expected * 2) t->capacity *= 2;
+    t->slots = counted_malloc(sizeof(int) * t->capacity);
+    assert(t->slots);
+    for (int i = 0; i < t->capacity; i++) t->slots[i] = -1;
+    t->names_cap = expected > 0 ? expected : 8;
+    t->names = counted_malloc(sizeof(char*) * t->names_cap);
+    t->hashes = counted_malloc(sizeof(unsigned) * t->names_cap);
+    assert(t->names && t->hashes);
+    t->arena = NULL;
+    return t;
+}
+
+//return the ID of name, adding a copy of it to the table if it is not there yet
+int intern(intern_table t, const char* name) {
+    assert(name != NULL);
+    unsigned hash = hash_string(name);
+    int slot = find_slot(t, name, hash);
+    if (t->slots[slot] != -1) return t->slots[slot];
+
+    if (t->size == t->names_cap) {
+        t->names_cap *= 2;
+        t->names = realloc(t->names, sizeof(char*) * t->names_cap);
+        t->hashes = realloc(t->hashes, sizeof(unsigned) * t->names_cap);
+        assert(t->names && t->hashes);
+    }
+    int id = t->size++;
+    t->names[id] = arena_copy(t, name);
+    t->hashes[id] = hash;
+    t->slots[slot] = id;
+
+    // Keep the load factor at or below one half so probe sequences stay short
+    if (t->size * 2 > t->capacity) grow_slots(t);
+    return id;
+}
+
+//return the ID of name, or -1 if it has not been interned
+int intern_lookup(intern_table t, const char* name) {
+    assert(name != NULL);
+    return t->slots[find_slot(t, name, hash_string(name))];
+}
+
+//return the interned string with the given ID
+char* intern_name(intern_table t, int id) {
+    assert(id >= 0 && id < t->size);
+    return t->names[id];
+}
+
+//free all memory associated with the table, including every interned string
+void drop_intern_table(intern_table t) {
+    struct arena_block* block = t->arena;
+    while (block != NULL) {
+        struct arena_block* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(t->slots);
+    free(t->hashes);
+    free(t->names);
+    free(t);
+}
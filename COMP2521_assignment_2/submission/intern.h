@@ -0,0 +1,39 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+//a block of the string arena, interned strings never move once copied in
+struct arena_block {
+    int used;
+    int size;
+    struct arena_block* next;
+    char text[];
+};
+
+//an open addressing table which maps strings (urls) to dense integer IDs 0, 1, 2, ...
+//in the order they were first interned
+typedef struct _intern_table {
+    int size;                   //number of strings interned
+    int capacity;               //number of slots, always a power of two
+    int* slots;                 //ID held by each slot, -1 when the slot is empty
+    unsigned* hashes;           //precomputed hash of each ID, used when probing and growing
+    char** names;               //string of each ID, pointing into the arena
+    int names_cap;
+    struct arena_block* arena;
+} *intern_table;
+
+//allocate a table sized for roughly 'expected' strings, it grows as needed
+intern_table create_intern_table(int expected);
+
+//return the ID of name, adding a copy of it to the table if it is not there yet
+int intern(intern_table t, const char* name);
+
+//return the ID of name, or -1 if it has not been interned
+int intern_lookup(intern_table t, const char* name);
+
+//return the interned string with the given ID
+char* intern_name(intern_table t, int id);
+
+//free all memory associated with the table, including every interned string
+void drop_intern_table(intern_table t);
+
+#endif
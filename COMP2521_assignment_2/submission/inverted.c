@@ -3,6 +3,7 @@
 #include <string.h>
 #include "BST.h"
 #include "read_data.h"
+#include "instrument.h"
 
 
 //using the lists returned from read_data.h construct the BST
@@ -10,6 +11,7 @@ Tree read_input(void);
 
 
 int main(int argc, char** argv) {
+	start_instrument(argv[0]);
 	//make sure there is a collection.txt file in the directory
 	FILE* test = fopen("collection.txt","r");
 	if(test == NULL) {
@@ -17,8 +19,12 @@ int main(int argc, char** argv) {
 		abort();
 	} else fclose(test);
 	
+    struct stage_timer timer = start_stage("read");
     Tree t = read_input();
+    stop_stage(timer);
+    timer = start_stage("write");
     display_in_order(t);
+    stop_stage(timer);
     drop_tree(t);
     return 0;
 }
@@ -26,15 +32,15 @@ int main(int argc, char** argv) {
 //helper function for the read_input function
 void read_words(Tree t, char* url) {
 
-    //read the content of the url file
-    Rep list = read_data(url);				
+    //read the url file, its terms point into its text
+    Document doc = read_document(url);
     
-    //insert each word (curr->info), indicating it is contained by url
-    for (Data curr = list->data_list; curr != NULL; curr = curr->next) {
-        insertAVL(t,curr->info,url);		
+    //insert each distinct word once, indicating it is contained by url
+    for (int i = 0; i < doc->n_terms; i++) {
+        insertAVL(t,doc->terms[i].str,url);
     }
-    // Free allocated memory
-    free_rep(list);
+    // Release the document
+    free_document(doc);
 }
 
 //using the lists returned from read_data.h construct the BST
@@ -47,8 +53,8 @@ Tree read_input(void) {
     Tree t = create_tree();
 
     // Read data from the URL file and insert it into the tree
-    for (Data curr = list->data_list; curr != NULL; curr = curr->next) {
-        read_words(t,curr->info);
+    for (int i = 0; i < list->size; i++) {
+        read_words(t,list->items[i].str);
     }
     
     // Free allocated memory
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "graph.h"
+#include "kernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_AVX2_KERNEL 1
+#endif
+
+//Pagerank pull kernels
+//both walk the transposed (in-edge) layout, so each vertex reads its own contiguous run of
+//weights and sources, with the damping factor already folded into the weights
+//the L1 diff is accumulated in the same pass as the update
+//the AVX2 kernel is compiled with a target attribute and only chosen at runtime when the CPU
+//supports it, so the binary still runs on older machines
+
+
+
+//return a copy of the transposed edge weights (in_weight) multiplied by the damping factor
+double* scale_weights(graph G, double damping_factor) {
+    double* scaled = malloc(sizeof(double) * (G->nE > 0 ? G->nE : 1));
+    assert(scaled);
+    for (int e = 0; e < G->nE; e++) scaled[e] = damping_factor*G->in_weight[e];
+    return scaled;
+}
+
+//portable version of the pull update, visiting the in-edges in order
+double pull_scalar(graph G, double* scaled, double teleport, double* old_rank, double* new_rank, int first, int last) {
+    double diff = 0;
+    for (int vert = first; vert < last; vert++) {
+        double rank = teleport;
+        for (int e = G->in_start[vert]; e < G->in_start[vert+1]; e++) {
+            rank += scaled[e]*old_rank[G->in_src[e]];
+        }
+        new_rank[vert] = rank;
+        diff += fabs(old_rank[vert]-rank);
+    }
+    return diff;
+}
+
+#ifdef HAVE_AVX2_KERNEL
+
+//AVX2 version of the pull update, four in-edges at a time, only valid where the CPU supports AVX2 and FMA
+__attribute__((target("avx2,fma")))
+double pull_avx2(graph G, double* scaled, double teleport, double* old_rank, double* new_rank, int first, int last) {
+    double diff = 0;
+    for (int vert = first; vert < last; vert++) {
+        int e = G->in_start[vert];
+        int end = G->in_start[vert+1];
+
+        // Gather the ranks of four sources at once and multiply them by their weights
+        __m256d sum = _mm256_setzero_pd();
+        for (; e + 4 <= end; e += 4) {
+            __m128i sources = _mm_loadu_si128((const __m128i*)(G->in_src + e));
+            __m256d ranks = _mm256_i32gather_pd(old_rank, sources, 8);
+            sum = _mm256_fmadd_pd(_mm256_loadu_pd(scaled + e), ranks, sum);
+        }
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+        half = _mm_add_sd(half, _mm_unpackhi_pd(half, half));
+        double rank = teleport + _mm_cvtsd_f64(half);
+
+        // Finish the edges that did not fill a vector
+        for (; e < end; e++) rank += scaled[e]*old_rank[G->in_src[e]];
+        new_rank[vert] = rank;
+        diff += fabs(old_rank[vert]-rank);
+    }
+    return diff;
+}
+
+//return the fastest pull update the running CPU supports
+pull_kernel select_pull_kernel(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return pull_avx2;
+    return pull_scalar;
+}
+
+#else
+
+//AVX2 is not available on this platform, fall back to the portable version
+double pull_avx2(graph G, double* scaled, double teleport, double* old_rank, double* new_rank, int first, int last) {
+    return pull_scalar(G, scaled, teleport, old_rank, new_rank, first, last);
+}
+
+//return the fastest pull update the running CPU supports
+pull_kernel select_pull_kernel(void) {
+    return pull_scalar;
+}
+
+#endif
+
+// calculate the weights of each of the edges in the graph by the Pagerank algorithm
+double* generate_weights(graph G, double damping_factor, double min_diff, int max_iterations, int* iterations) {
+	int size = G->nV;
+
+    // Declare two arrays of type double
+    double* new_rank = malloc(sizeof(double)*size);
+    double* old_rank = malloc(sizeof(double)*size);
+    
+    // The initial value of the pagerank should equal to 1 divided by the number of URLs
+    for(int i = 0; i < size; i++) old_rank[i] = 1.0/size;
+
+
+    int count = 0;
+    
+    // The pull kernel walks the in-edges of every vertex with the damping factor folded into
+    // the weights and returns the difference between the old and new ranks
+    double* scaled = scale_weights(G, damping_factor);
+    pull_kernel pull = select_pull_kernel();
+
+    // While the limit of iterations has not been reached, continue to iterate and compute the pagerank values
+    while (count < max_iterations) {
+        double diff = pull(G, scaled, (1-damping_factor)/size, old_rank, new_rank, 0, size);
+        
+        // While the difference is still greater than the minimum suggested value, continue to compute the pagerank values
+        if (diff < min_diff) {
+            count++;
+            break;
+        }
+        for(int i = 0; i < size; i++) old_rank[i] = new_rank[i];
+        count++;
+    }
+    
+    *iterations = count;
+    free(scaled);
+    free(old_rank);
+	return new_rank;
+}
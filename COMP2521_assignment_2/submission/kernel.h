@@ -0,0 +1,27 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include "graph.h"
+
+//one pull update of the vertices first .. last-1:
+//new_rank[v] = teleport + sum of scaled[e]*old_rank[in_src[e]] over the in-edges e of v
+//returns the L1 diff between old_rank and new_rank over those vertices
+typedef double (*pull_kernel)(graph G, double* scaled, double teleport, double* old_rank, double* new_rank, int first, int last);
+
+//return a copy of the transposed edge weights (in_weight) multiplied by the damping factor
+double* scale_weights(graph G, double damping_factor);
+
+//portable version of the pull update, visiting the in-edges in order
+double pull_scalar(graph G, double* scaled, double teleport, double* old_rank, double* new_rank, int first, int last);
+
+//AVX2 version of the pull update, four in-edges at a time, only valid where the CPU supports AVX2 and FMA
+double pull_avx2(graph G, double* scaled, double teleport, double* old_rank, double* new_rank, int first, int last);
+
+//return the fastest pull update the running CPU supports
+pull_kernel select_pull_kernel(void);
+
+//calculate the Pagerank of every vertex by Jacobi iteration with the fastest pull update, stopping
+//once the L1 diff of an iteration is below min_diff; the iterations made are stored in *iterations
+double* generate_weights(graph G, double damping_factor, double min_diff, int max_iterations, int* iterations);
+
+#endif
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include "graph.h"
+#include "read_data.h"
+#include "threads.h"
+#include "loader.h"
+
+//Parallel url file loading
+//threads claim blocks of vertices from a shared counter (url files vary a lot in size, so fixed chunks
+//would leave threads idle), load each vertex's file with open_url_file and resolve the links to vertex
+//IDs through the read-only intern table, appending them to a buffer owned by the thread
+//the graph itself is only changed afterwards, by one thread, in vertex order
+
+#define BLOCK_SIZE 32
+
+//the links parsed by one thread
+struct link_buffer {
+    int* targets;
+    int size;
+    int cap;
+};
+
+struct load_job {
+    graph G;
+    pthread_mutex_t lock;
+    int next_vertex;
+    struct link_buffer* buffers;        //one per thread
+    int* owner;                         //thread that parsed each vertex
+    int* first;                         //index of each vertex's first link in its owner's buffer
+    int* count;                         //number of links of each vertex
+};
+
+
+
+//helper functions//
+
+
+//append a vertex ID to a link buffer
+static void append_link(struct link_buffer* buffer, int target) {
+    if (buffer->size == buffer->cap) {
+        buffer->cap = buffer->cap > 0 ? buffer->cap * 2 : 1024;
+        buffer->targets = realloc(buffer->targets, sizeof(int) * buffer->cap);
+        assert(buffer->targets);
+    }
+    buffer->targets[buffer->size++] = target;
+}
+
+//claim the next block of vertices, returning the first of them (nV once none are left)
+static int claim_block(struct load_job* job) {
+    pthread_mutex_lock(&job->lock);
+    int first = job->next_vertex;
+    job->next_vertex += BLOCK_SIZE;
+    pthread_mutex_unlock(&job->lock);
+    return first < job->G->nV ? first : job->G->nV;
+}
+
+//parse the url files of the claimed vertices into this thread's buffer
+static void load_worker(int id, void* arg) {
+    struct load_job* job = arg;
+    graph G = job->G;
+    struct link_buffer* buffer = &job->buffers[id];
+
+    for (int first = claim_block(job); first < G->nV; first = claim_block(job)) {
+        int last = first + BLOCK_SIZE < G->nV ? first + BLOCK_SIZE : G->nV;
+        for (int vert = first; vert < last; vert++) {
+            UrlFile file = open_url_file(G->map[vert]);
+            G->stamps[vert + 1] = file->stamp;
+            job->owner[vert] = id;
+            job->first[vert] = buffer->size;
+            for (int i = 0; i < file->n_links; i++) {
+                append_link(buffer, vertex_ID(G, file->links[i].str));
+            }
+            job->count[vert] = buffer->size - job->first[vert];
+            close_url_file(file);
+        }
+    }
+}
+
+
+
+//read the outlinks of every vertex of G from its url file using 'threads' threads and add them to G
+void parallel_get_links(graph G, int threads) {
+    if (threads < 1) threads = 1;
+    struct load_job job;
+    job.G = G;
+    pthread_mutex_init(&job.lock, NULL);
+    job.next_vertex = 0;
+    job.buffers = calloc(threads, sizeof(struct link_buffer));
+    job.owner = malloc(sizeof(int) * (G->nV > 0 ? G->nV : 1));
+    job.first = malloc(sizeof(int) * (G->nV > 0 ? G->nV : 1));
+    job.count = malloc(sizeof(int) * (G->nV > 0 ? G->nV : 1));
+    assert(job.buffers && job.owner && job.first && job.count);
+
+    run_threads(threads, load_worker, &job);
+
+    // Add the edges in vertex order, exactly as the serial loader does
+    for (int vert = 0; vert < G->nV; vert++) {
+        //a url listed twice in collection.txt adds its links from the first vertex with that name
+        int from = vertex_ID(G, G->map[vert]);
+        int* targets = job.buffers[job.owner[vert]].targets + job.first[vert];
+        for (int i = 0; i < job.count[vert]; i++) {
+            if (targets[i] == -1) {
+                fprintf(stderr, "%s links to a url that is not in collection.txt\n", G->map[vert]);
+                abort();
+            }
+            add_edge_by_ID(G, from, targets[i]);
+        }
+    }
+
+    for (int t = 0; t < threads; t++) free(job.buffers[t].targets);
+    free(job.buffers);
+    free(job.owner);
+    free(job.first);
+    free(job.count);
+    pthread_mutex_destroy(&job.lock);
+}
+
+// using the lists returned from read_data.h construct the graph, reading the url files on 'threads' threads
+graph load_graph(int threads) {
+
+    // Read data from collection.txt
+    Rep list = read_collection();
+
+    // Create a sparse graph with size list->size, stamping each file as it is read
+    graph G = create_graph(list->size);
+    G->stamps = malloc(sizeof(struct source_stamp) * ((long)G->nV + 1));
+    assert(G->stamps);
+    G->stamps[0] = list->stamp;
+
+    // Add vertices into the graph G
+    for (int i = 0; i < list->size; i++) {
+        add_vertex(G,list->items[i].str);
+    }
+
+    free_rep(list);
+
+    // the string name of each url is now stored in the graph data structure
+    // use these to create the edges in the graph
+    if (threads > 1) {
+        parallel_get_links(G, threads);
+    } else {
+        for (int i = 0 ; i < G->nV; i++) {
+            get_links(G,i);
+        }
+    }
+    return G;
+}
+
+//add all the edges starting from vertex "vert" into G
+void get_links(graph G, int vert) {
+
+    // Get all the outgoing links from the file of vert
+    UrlFile file = open_url_file(G->map[vert]);
+    G->stamps[vert + 1] = file->stamp;
+
+    // Add edges into the graph g
+    for (int i = 0; i < file->n_links; i++) {
+        add_edge(G,G->map[vert],file->links[i].str);
+    }
+
+    close_url_file(file);
+}
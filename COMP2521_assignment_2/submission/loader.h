@@ -0,0 +1,19 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include "graph.h"
+
+//read the outlinks of every vertex of G from its url file using 'threads' threads and add them to G
+//the files are parsed concurrently into per-thread buffers, which are then added to G in vertex order,
+//so the graph is the same whatever the number of threads
+void parallel_get_links(graph G, int threads);
+
+//read the urls in collection.txt and their links into a new graph, reading the url files on 'threads'
+//threads; the graph is not yet compressed or weighted
+//G->stamps records each file as it was opened, before it was read
+graph load_graph(int threads);
+
+//add all the edges starting from vertex "vert" into G
+void get_links(graph G, int vert);
+
+#endif
@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include "graph.h"
+#include "packed.h"
+
+//Packed adjacency
+//the sources of every in-edge list are sorted, so they are stored as gaps from the previous source
+//(the first from 0) in groups of four: a control byte holding the byte length (1-4) of each gap,
+//then the low bytes of the gaps; a graph with locality mostly needs one or two bytes per edge
+//instead of a 4 byte ID and an 8 byte weight
+//decoding is branch free: a table gives the offset and mask of every gap of a group from its control
+//byte, and each gap is a 4 byte load masked to its length, which is why the bytes are padded at the end
+//the weights are not stored at all: every update first scales each rank by its source's factor,
+//then each vertex only sums the scaled ranks of its sources and multiplies by its own factor
+//the ranks match generate_weights to rounding, the products are just taken in a different order
+
+//bytes after the last gap, so the last 4 byte load stays inside the array
+#define PADDING 3
+
+//the low bytes kept of a gap of each length
+static const unsigned length_mask[4] = {0xFF, 0xFFFF, 0xFFFFFF, 0xFFFFFFFF};
+
+//for every control byte: where each of the four gaps starts after it, their masks and the group size
+struct group_layout {
+    unsigned char offset[4];
+    unsigned char total;
+    unsigned mask[4];
+};
+static struct group_layout layouts[256];
+static int layouts_ready = 0;
+
+
+
+//helper functions//
+
+
+//the number of bytes (1-4) needed to store 'value'
+static int byte_length(unsigned value) {
+    if (value < (1u << 8)) return 1;
+    if (value < (1u << 16)) return 2;
+    if (value < (1u << 24)) return 3;
+    return 4;
+}
+
+//append up to four gaps as a group to bytes, returning the new length
+static long long put_group(unsigned char* bytes, long long length, unsigned* gaps, int count) {
+    long long control = length++;
+    bytes[control] = 0;
+    for (int k = 0; k < count; k++) {
+        int size = byte_length(gaps[k]);
+        bytes[control] |= (size - 1) << (2*k);
+        for (int b = 0; b < size; b++) bytes[length++] = gaps[k] >> (8*b);
+    }
+    return length;
+}
+
+//fill in the layout of every control byte
+static void build_layouts(void) {
+    if (layouts_ready) return;
+    for (int control = 0; control < 256; control++) {
+        int offset = 1;
+        for (int k = 0; k < 4; k++) {
+            int size = ((control >> (2*k)) & 3) + 1;
+            layouts[control].offset[k] = offset;
+            layouts[control].mask[k] = length_mask[size - 1];
+            offset += size;
+        }
+        layouts[control].total = offset;
+    }
+    layouts_ready = 1;
+}
+
+//read a 4 byte value from any address (the gaps are written little endian, as x86 reads them)
+static inline unsigned load4(const unsigned char* p) {
+    unsigned value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+
+
+//encode the in-edges of a compressed graph, which needs its link counts but not its weights
+packed_graph pack_graph(graph G) {
+    count_links(G);
+    build_layouts();
+    int nV = G->nV;
+    packed_graph P = malloc(sizeof(struct _packed_graph));
+    assert(P);
+    P->nV = nV;
+    P->start = malloc(sizeof(long long) * (nV + 1));
+    P->count = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    //a group of four gaps never needs more than 17 bytes
+    P->bytes = malloc(5 * (long long)G->nE + PADDING + 1);
+    P->source_scale = calloc(nV > 0 ? nV : 1, sizeof(double));
+    P->dest_scale = malloc(sizeof(double) * (nV > 0 ? nV : 1));
+    assert(P->start && P->count && P->bytes && P->source_scale && P->dest_scale);
+
+    // The same factors caclulate_weights uses, split between the two ends of an edge
+    for (int v = 0; v < nV; v++) {
+        double I_v = G->links[v].links_in;
+        double O_v = G->links[v].links_out > 0 ? G->links[v].links_out : 0.5;
+        P->dest_scale[v] = I_v * O_v;
+    }
+    for (int u = 0; u < nV; u++) {
+        double sum_I = 0;
+        double sum_O = 0;
+        for (int e = G->out_start[u]; e < G->out_start[u+1]; e++) {
+            int j = G->out_dest[e];
+            sum_I += G->links[j].links_in;
+            sum_O += G->links[j].links_out > 0 ? G->links[j].links_out : 0.5;
+        }
+        if (sum_I > 0) P->source_scale[u] = 1/(sum_I*sum_O);
+    }
+
+    long long length = 0;
+    for (int v = 0; v < nV; v++) {
+        P->start[v] = length;
+        P->count[v] = G->in_start[v+1] - G->in_start[v];
+        int previous = 0;
+        unsigned gaps[4];
+        int k = 0;
+        for (int e = G->in_start[v]; e < G->in_start[v+1]; e++) {
+            gaps[k++] = G->in_src[e] - previous;
+            previous = G->in_src[e];
+            if (k == 4) {
+                length = put_group(P->bytes, length, gaps, 4);
+                k = 0;
+            }
+        }
+        if (k > 0) length = put_group(P->bytes, length, gaps, k);
+    }
+    P->start[nV] = length;
+    for (int b = 0; b < PADDING; b++) P->bytes[length + b] = 0;
+    P->bytes = realloc(P->bytes, length + PADDING);
+    assert(P->bytes);
+    return P;
+}
+
+//free all memory associated with the packed graph
+void drop_packed_graph(packed_graph P) {
+    free(P->start);
+    free(P->count);
+    free(P->bytes);
+    free(P->source_scale);
+    free(P->dest_scale);
+    free(P);
+}
+
+//one pull update of every vertex from the packed in-edges, returning the L1 diff
+double pull_packed(packed_graph P, double damping_factor, double* old_rank, double* new_rank, double* scaled) {
+    int size = P->nV;
+    double teleport = (1-damping_factor)/size;
+    for (int u = 0; u < size; u++) scaled[u] = P->source_scale[u]*old_rank[u];
+
+    double diff = 0;
+    for (int vert = 0; vert < size; vert++) {
+        const unsigned char* p = P->bytes + P->start[vert];
+        int src = 0;
+        double sum = 0;
+        int left = P->count[vert];
+
+        // Whole groups: the four sources are found from the control byte alone, so their ranks can
+        // be loaded in parallel
+        double sum1 = 0, sum2 = 0, sum3 = 0;
+        for (; left >= 4; left -= 4) {
+            const struct group_layout* l = &layouts[*p];
+            int s0 = src + (load4(p + l->offset[0]) & l->mask[0]);
+            int s1 = s0 + (load4(p + l->offset[1]) & l->mask[1]);
+            int s2 = s1 + (load4(p + l->offset[2]) & l->mask[2]);
+            src = s2 + (load4(p + l->offset[3]) & l->mask[3]);
+            sum += scaled[s0];
+            sum1 += scaled[s1];
+            sum2 += scaled[s2];
+            sum3 += scaled[src];
+            p += l->total;
+        }
+        sum += sum1 + sum2 + sum3;
+
+        // The last, partial group
+        if (left > 0) {
+            const struct group_layout* l = &layouts[*p];
+            for (int k = 0; k < left; k++) {
+                src += load4(p + l->offset[k]) & l->mask[k];
+                sum += scaled[src];
+            }
+        }
+        double rank = teleport + damping_factor*P->dest_scale[vert]*sum;
+        new_rank[vert] = rank;
+        diff += fabs(old_rank[vert]-rank);
+    }
+    return diff;
+}
+
+//calculate the Pagerank of every vertex from the packed in-edges, iterating like generate_weights
+double* packed_weights(packed_graph P, double damping_factor, double min_diff, int max_iterations, int* iterations) {
+    int size = P->nV;
+    double* new_rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    double* old_rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    double* scaled = malloc(sizeof(double) * (size > 0 ? size : 1));
+    assert(new_rank && old_rank && scaled);
+    for (int i = 0; i < size; i++) old_rank[i] = new_rank[i] = 1.0/size;
+
+    int count = 0;
+    while (count < max_iterations) {
+        double diff = pull_packed(P, damping_factor, old_rank, new_rank, scaled);
+        count++;
+        if (diff < min_diff || count == max_iterations) break;
+        double* temp = old_rank;
+        old_rank = new_rank;
+        new_rank = temp;
+    }
+
+    *iterations = count;
+    free(old_rank);
+    free(scaled);
+    return new_rank;
+}
@@ -0,0 +1,32 @@
+#ifndef PACKED_H
+#define PACKED_H
+
+#include "graph.h"
+
+//the in-edges of a graph with their sources gap encoded as varints and no stored weights
+//the weight of u -> v is I_v*O_v / (sum_I[u]*sum_O[u]) (see caclulate_weights), so it is rebuilt from
+//dest_scale[v] = I_v*O_v and source_scale[u] = 1/(sum_I[u]*sum_O[u])
+typedef struct _packed_graph {
+    int nV;
+    long long* start;           //the sources of v are encoded in bytes[start[v]] .. bytes[start[v+1]-1]
+    int* count;                 //the number of in-edges of every vertex
+    unsigned char* bytes;
+    double* source_scale;
+    double* dest_scale;
+} *packed_graph;
+
+//encode the in-edges of a compressed graph, which needs its link counts but not its weights
+packed_graph pack_graph(graph G);
+
+//free all memory associated with the packed graph
+void drop_packed_graph(packed_graph P);
+
+//one pull update of every vertex from the packed in-edges, returning the L1 diff
+//'scaled' is scratch space of nV doubles
+double pull_packed(packed_graph P, double damping_factor, double* old_rank, double* new_rank, double* scaled);
+
+//calculate the Pagerank of every vertex from the packed in-edges, iterating like generate_weights
+//only P is read, so the graph it was packed from can drop its edges first (see drop_edges)
+double* packed_weights(packed_graph P, double damping_factor, double min_diff, int max_iterations, int* iterations);
+
+#endif
@@ -4,166 +4,461 @@
 #include <assert.h>
 #include <math.h>
 #include "graph.h"
-#include "read_data.h"
+#include "kernel.h"
+#include "parallel_rank.h"
+#include "gauss_seidel.h"
+#include "accelerate.h"
+#include "incremental.h"
+#include "snapshot.h"
+#include "loader.h"
+#include "personalized.h"
+#include "push.h"
+#include "reorder.h"
+#include "batch.h"
+#include "stream.h"
+#include "packed.h"
+#include "scc.h"
+#include "single.h"
+#include "checkpoint.h"
+#include "ranking.h"
+#include "instrument.h"
 
+//optional settings given after the three required arguments
+struct options {
+    int threads;            //-j N: read the url files and share each iteration between N threads
+    int gauss_seidel;       //--gauss-seidel: update the ranks in place, on one thread
+    int verbose;            //-v: report the number of iterations on stderr
+    enum extrapolation accelerate;  //--accelerate aitken|quadratic: periodically extrapolate the ranks
+    int residuals;          //--residuals: print the residual of every iteration on stderr
+    char* warm_start;       //--warm-start FILE: continue from the ranks of a previous run (rank state or pagerankList.txt)
+    char* save_state;       //--save-state FILE: write the exact ranks to a binary rank state file
+    char* snapshot;         //--snapshot FILE: map the graph from FILE, or build it and write FILE
+    int top;                //--top K: only rank and write the K most important urls (-1 for all)
+    char* seeds;            //--personalize url[:weight],...: jump only to the given urls
+    int push;               //--push: solve by pushing residuals from a work list (locally from the seeds if personalized)
+    enum vertex_order order;        //--reorder degree|rcm: renumber the vertices before solving
+    char* dampings;         //--dampings d1,d2,...: rank for every damping factor in one run, into pagerankList-d.txt
+    char* stream;           //--stream FILE: rank from an edge file read once per iteration, building FILE if needed
+    int packed;             //--packed: iterate over varint encoded in-edges with the weights rebuilt from the link counts
+    int scc;                //--scc: solve one strongly connected component at a time, upstream components first
+    int single;             //--float: store the weights and ranks in single precision
+    int check_top;          //--check-float N: also run in double precision and compare the top N urls
+    char* checkpoint;       //--checkpoint FILE: save the ranks to FILE every few iterations
+    int checkpoint_period;  //--checkpoint-every N: iterations between checkpoints (10 by default)
+    int resume;             //--resume: continue from the checkpoint in the --checkpoint file
+};
 
 
-// using the lists returned from read_data.h construct the graph
-graph read_input(void);
 
-//add all the edges starting from "vert" into G
-void get_links(graph G, char* vert);
+//print the usage message and exit
+void usage(char* program);
 
-//calculate the weights of each of the edges in the graph by the Pagerank algorithm
-double* generate_weights(graph G, double damping_factor, double min_diff, int max_iterations);
+//read the optional arguments that follow the three required ones
+struct options parse_options(int argc, char** argv);
 
-//return a list of indexes which ranks the vertices by their importance
-int* generate_sorted_indexes(graph G, double* weights);
+// construct the graph from collection.txt, reading the url files on 'threads' threads
+// the edge weights are only calculated if 'weighted' (the packed solver rebuilds them from the link counts)
+graph read_input(int threads, int weighted);
+
+//compare the 'top' most important urls by two rank vectors, reporting the result on stderr
+//returns 0 if they are in the same order and 1 otherwise
+int compare_top(graph G, double* weights, double* exact, int top);
+
+//rank from an edge stream file, building it from the url files first if it is missing or out of date
+void stream_pagerank(struct options opts, double damping_factor, double min_diff, int max_iterations);
+
+//rank every damping factor in the comma separated list, writing each ranking to pagerankList-<factor>.txt
+//if the graph was reordered it is restored to collection order first
+void rank_dampings(graph G, char* list, double min_diff, int max_iterations, int top, int verbose, int* order);
+
+//write the name of the ranking file of a damping factor, pagerankList-<factor>.txt, into name
+void damping_file_name(double damping_factor, char* name, int size);
 
 int main(int argc, char ** argv) {
-    if (argc != 4) {
-        fprintf(stderr,"Usage: %s [damping factor] [min_diff] [max_iterations]\n",argv[0]);
-        abort();
-    }
+    if (argc < 4) usage(argv[0]);
+    start_instrument(argv[0]);
     
     // Read in arguments for generate_weight
     double damping_factor = atof(argv[1]);
     double min_diff = atof(argv[2]);
     int max_iterations = atoi(argv[3]);
+    struct options opts = parse_options(argc, argv);
 
-    // Read URLs from collection.txt
-    graph G = read_input();
-    
-    // Compute the weighted pagerank for each URL
-    double* weights = generate_weights(G, damping_factor,min_diff,max_iterations);
+    // Rank out of core if asked, only the rank vectors are kept in memory
+    if (opts.stream) {
+        stream_pagerank(opts, damping_factor, min_diff, max_iterations);
+        return 0;
+    }
+
+    // Map a snapshot of the graph if one is given and none of its source files has changed, otherwise
+    // read URLs from collection.txt (and save a snapshot for the next run)
+    struct stage_timer timer = start_stage("load");
+    graph G = opts.snapshot ? load_graph_snapshot(opts.snapshot, 1) : NULL;
+    if (G == NULL) {
+        //a snapshot always holds the weights, so it can be mapped for any solver
+        G = read_input(opts.threads, !opts.packed || opts.snapshot != NULL);
+        if (opts.snapshot) write_graph_snapshot(G, opts.snapshot);
+    }
+    stop_stage(timer);
     
-    // Sort the weights generated from the function above
-    int* sorted_indexes = generate_sorted_indexes(G, weights);
+    // Renumber the vertices for locality, the ranks are moved back to collection order after solving
+    int* order = NULL;
+    if (opts.order != ORDER_NONE) {
+        order = vertex_order(G, opts.order);
+        reorder_graph(G, order, NULL);
+    }
+    int top = opts.top >= 0 && opts.top < G->nV ? opts.top : G->nV;
+
+    // A list of damping factors is ranked in one batched run
+    if (opts.dampings) {
+        rank_dampings(G, opts.dampings, min_diff, max_iterations, top, opts.verbose, order);
+        free(order);
+        drop_graph(G);
+        return 0;
+    }
 
-    // Create a text file called pageRankList.txt
-    FILE* output = fopen("pagerankList.txt","w");
-    assert(output);
+    // Compute the weighted pagerank for each URL
+    timer = start_stage("solve");
+    double* weights;
+    int iterations = 0;
+    char* method = "jacobi";
+    //a warm start only applies to the global ranks (--personalize is refused with it), the previous ranks are found by url so they follow any reordering
+    double* previous = opts.warm_start ? read_previous_ranks(G, opts.warm_start) : NULL;
+    if (opts.warm_start && previous == NULL) {
+        fprintf(stderr,"%s: can not read %s, starting from uniform ranks\n",argv[0],opts.warm_start);
+    }
+    if (opts.seeds) {
+        teleport t = parse_teleport(G, opts.seeds);
+        if (opts.push) {
+            long pushes = 0;
+            weights = personalized_push(G, damping_factor, min_diff, t, &pushes);
+            //the push solver has no iterations, report the pushes it made instead
+            method = NULL;
+            if (opts.verbose) fprintf(stderr,"push: %ld pushes\n",pushes);
+        } else {
+            weights = personalized_weights(G, damping_factor, min_diff, max_iterations, t, &iterations);
+            method = "personalized";
+        }
+        drop_teleport(t);
+    } else if (previous != NULL) {
+        long updates = 0;
+        weights = incremental_weights(G, damping_factor, min_diff, max_iterations, previous, &iterations, &updates);
+        method = "incremental";
+        if (opts.verbose) fprintf(stderr,"incremental: %ld vertex updates (a full sweep is %d)\n",updates,G->nV);
+    } else if (opts.push) {
+        long pushes = 0;
+        long edges = 0;
+        weights = push_weights(G, damping_factor, min_diff, max_iterations, &pushes, &edges);
+        method = NULL;
+        if (opts.verbose) fprintf(stderr,"push: %ld pushes, %ld edges visited\n",pushes,edges);
+    } else if (opts.scc) {
+        int count = 0;
+        long updates = 0;
+        weights = scc_weights(G, damping_factor, min_diff, max_iterations, opts.threads, &count, &updates);
+        method = NULL;
+        if (opts.verbose) fprintf(stderr,"scc: %d components, %ld vertex updates (a full sweep is %d)\n",count,updates,G->nV);
+    } else if (opts.checkpoint) {
+        weights = checkpointed_weights(G, damping_factor, min_diff, max_iterations, opts.checkpoint,
+                                       opts.checkpoint_period, opts.resume, opts.order, &iterations);
+        method = "checkpointed";
+    } else if (opts.single) {
+        weights = float_weights(G, damping_factor, min_diff, max_iterations, &iterations);
+        method = "float";
+    } else if (opts.packed) {
+        //the packed in-edges replace the graph's own, only the names and link counts are kept for the ranking
+        packed_graph P = pack_graph(G);
+        drop_edges(G);
+        weights = packed_weights(P, damping_factor, min_diff, max_iterations, &iterations);
+        drop_packed_graph(P);
+        method = "packed";
+    } else if (opts.gauss_seidel) {
+        weights = gauss_seidel_weights(G, damping_factor, min_diff, max_iterations, &iterations);
+        method = "gauss-seidel";
+    } else if (opts.accelerate != EXTRAPOLATE_NONE || opts.residuals) {
+        weights = accelerated_weights(G, damping_factor, min_diff, max_iterations, opts.accelerate,
+                                      opts.residuals ? stderr : NULL, &iterations);
+        if (opts.accelerate == EXTRAPOLATE_AITKEN) method = "aitken";
+        if (opts.accelerate == EXTRAPOLATE_QUADRATIC) method = "quadratic";
+    } else if (opts.threads > 1) {
+        weights = parallel_generate_weights(G, damping_factor, min_diff, max_iterations, opts.threads, &iterations);
+    } else {
+        weights = generate_weights(G, damping_factor,min_diff,max_iterations,&iterations);
+    }
+    stop_stage(timer);
+    if (opts.verbose && method) fprintf(stderr,"%s: %d iterations, %ld edges visited\n",method,iterations,(long)iterations*G->nE);
+    if (order != NULL) {
+        restore_order(G, order, weights);
+        free(order);
+    }
     
-    // Write the url, the number of outlinks and the weighted pagerank into the opened file
-    for(int i = 0; i < G->nV; i++) {
-        int index = sorted_indexes[i];
-        fprintf(output,"%s, %d, %.7lf\n",G->map[index],G->links[index].links_out,weights[i]);
+    // Check the single precision ranking against a double precision run
+    int status = 0;
+    if (opts.single && opts.check_top > 0) {
+        int check_iterations = 0;
+        double* exact = generate_weights(G, damping_factor, min_diff, max_iterations, &check_iterations);
+        status = compare_top(G, weights, exact, opts.check_top);
+        free(exact);
     }
+
+    // The ranks are still in vertex order here, before sorting
+    if (opts.save_state) write_rank_state(G, weights, opts.save_state);
+
+    // Sort the weights generated from the function above and write them to pagerankList.txt
+    timer = start_stage("write");
+    write_ranking(G, weights, top, "pagerankList.txt");
+    stop_stage(timer);
     
-    // Free memory associated with malloced data structures and close any existing file pointers
-    free(sorted_indexes);
+    // Free memory associated with malloced data structures
     free(weights);
     drop_graph(G);
-    fclose(output);
-    return 0;
+    return status;
 }
 
-// using the lists returned from read_data.h construct the graph
-graph read_input(void) {
+//print the usage message and exit
+void usage(char* program) {
+    fprintf(stderr,"Usage: %s [damping factor] [min_diff] [max_iterations] [-j threads] [--gauss-seidel] [--accelerate aitken|quadratic] [--residuals] [--warm-start file] [--save-state file] [--snapshot file] [--top K] [--personalize url[:weight],...] [--push] [--reorder degree|rcm] [--dampings d1,d2,...] [--stream file] [--packed] [--scc] [--float [--check-float N]] [--checkpoint file [--checkpoint-every N] [--resume]] [-v]\n",program);
+    abort();
+}
 
-    // Read data from collection.txt
-    Rep list = read_collection();
+//read the optional arguments that follow the three required ones
+struct options parse_options(int argc, char** argv) {
+    struct options opts;
+    opts.threads = 1;
+    opts.gauss_seidel = 0;
+    opts.verbose = 0;
+    opts.accelerate = EXTRAPOLATE_NONE;
+    opts.residuals = 0;
+    opts.warm_start = NULL;
+    opts.save_state = NULL;
+    opts.snapshot = NULL;
+    opts.top = -1;
+    opts.seeds = NULL;
+    opts.push = 0;
+    opts.order = ORDER_NONE;
+    opts.dampings = NULL;
+    opts.stream = NULL;
+    opts.packed = 0;
+    opts.scc = 0;
+    opts.single = 0;
+    opts.check_top = 0;
+    opts.checkpoint = NULL;
+    opts.checkpoint_period = 10;
+    opts.resume = 0;
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i],"-j") == 0 && i + 1 < argc) {
+            opts.threads = atoi(argv[++i]);
+            if (opts.threads < 1) usage(argv[0]);
+        } else if (strcmp(argv[i],"--gauss-seidel") == 0) {
+            opts.gauss_seidel = 1;
+        } else if (strcmp(argv[i],"--accelerate") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i],"aitken") == 0) opts.accelerate = EXTRAPOLATE_AITKEN;
+            else if (strcmp(argv[i],"quadratic") == 0) opts.accelerate = EXTRAPOLATE_QUADRATIC;
+            else usage(argv[0]);
+        } else if (strcmp(argv[i],"--residuals") == 0) {
+            opts.residuals = 1;
+        } else if (strcmp(argv[i],"--warm-start") == 0 && i + 1 < argc) {
+            opts.warm_start = argv[++i];
+        } else if (strcmp(argv[i],"--save-state") == 0 && i + 1 < argc) {
+            opts.save_state = argv[++i];
+        } else if (strcmp(argv[i],"--snapshot") == 0 && i + 1 < argc) {
+            opts.snapshot = argv[++i];
+        } else if (strcmp(argv[i],"--top") == 0 && i + 1 < argc) {
+            opts.top = atoi(argv[++i]);
+            if (opts.top < 0) usage(argv[0]);
+        } else if (strcmp(argv[i],"--personalize") == 0 && i + 1 < argc) {
+            opts.seeds = argv[++i];
+        } else if (strcmp(argv[i],"--push") == 0) {
+            opts.push = 1;
+        } else if (strcmp(argv[i],"--reorder") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i],"degree") == 0) opts.order = ORDER_DEGREE;
+            else if (strcmp(argv[i],"rcm") == 0) opts.order = ORDER_RCM;
+            else usage(argv[0]);
+        } else if (strcmp(argv[i],"--dampings") == 0 && i + 1 < argc) {
+            opts.dampings = argv[++i];
+        } else if (strcmp(argv[i],"--stream") == 0 && i + 1 < argc) {
+            opts.stream = argv[++i];
+        } else if (strcmp(argv[i],"--packed") == 0) {
+            opts.packed = 1;
+        } else if (strcmp(argv[i],"--scc") == 0) {
+            opts.scc = 1;
+        } else if (strcmp(argv[i],"--float") == 0) {
+            opts.single = 1;
+        } else if (strcmp(argv[i],"--check-float") == 0 && i + 1 < argc) {
+            opts.check_top = atoi(argv[++i]);
+            if (opts.check_top < 1) usage(argv[0]);
+        } else if (strcmp(argv[i],"--checkpoint") == 0 && i + 1 < argc) {
+            opts.checkpoint = argv[++i];
+        } else if (strcmp(argv[i],"--checkpoint-every") == 0 && i + 1 < argc) {
+            opts.checkpoint_period = atoi(argv[++i]);
+            if (opts.checkpoint_period < 1) usage(argv[0]);
+        } else if (strcmp(argv[i],"--resume") == 0) {
+            opts.resume = 1;
+        } else if (strcmp(argv[i],"-v") == 0) {
+            opts.verbose = 1;
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (opts.resume && opts.checkpoint == NULL) usage(argv[0]);
+    if (opts.check_top > 0 && !opts.single) usage(argv[0]);
 
-    // Create an adjacency matrix graph with size list->size
-    graph G = create_graph(list->size);
+    // Each of these picks how the ranks are solved, so only one may be given
+    // (--push is the personalized solver when it comes with --personalize)
+    char* solvers[12];
+    int count = 0;
+    if (opts.stream) solvers[count++] = "--stream";
+    if (opts.dampings) solvers[count++] = "--dampings";
+    if (opts.seeds) solvers[count++] = "--personalize";
+    if (opts.warm_start) solvers[count++] = "--warm-start";
+    if (opts.push && !opts.seeds) solvers[count++] = "--push";
+    if (opts.scc) solvers[count++] = "--scc";
+    if (opts.checkpoint) solvers[count++] = "--checkpoint";
+    if (opts.single) solvers[count++] = "--float";
+    if (opts.packed) solvers[count++] = "--packed";
+    if (opts.gauss_seidel) solvers[count++] = "--gauss-seidel";
+    if (opts.accelerate != EXTRAPOLATE_NONE) solvers[count++] = "--accelerate";
+    else if (opts.residuals) solvers[count++] = "--residuals";
+    if (count > 1) {
+        fprintf(stderr,"%s: %s and %s choose different solvers, give only one of them\n",argv[0],solvers[0],solvers[1]);
+        usage(argv[0]);
+    }
 
-    // Add vertices into the graph G
-    for (Data curr = list->data_list; curr != NULL; curr = curr->next) {
-        add_vertex(G,curr->info);
+    // Options which only some solvers use are refused with the others rather than ignored
+    // (-j threads the default Jacobi solver and --scc, --stream ranks from its own edge file)
+    char* ignored = NULL;
+    if (opts.threads > 1 && count > 0 && !opts.scc) ignored = "-j";
+    else if (opts.stream && opts.save_state) ignored = "--save-state";
+    else if (opts.stream && opts.snapshot) ignored = "--snapshot";
+    else if (opts.stream && opts.order != ORDER_NONE) ignored = "--reorder";
+    else if (opts.dampings && opts.save_state) ignored = "--save-state";
+    if (ignored != NULL) {
+        fprintf(stderr,"%s: %s does not apply to %s\n",argv[0],ignored,solvers[0]);
+        usage(argv[0]);
     }
+    return opts;
+}
 
-    free_rep(list);
+// construct the graph from collection.txt, reading the url files on 'threads' threads
+graph read_input(int threads, int weighted) {
 
-    // the string name of each url is now stored in the graph data structure
-    // use these to create the edges in the graph
-    for (int i = 0 ; i < G->nV; i++) {
-        get_links(G,G->map[i]);							
-    }													
+    // Read the urls and their links
+    graph G = load_graph(threads);
 
     // Calculate the product of w_in and w_out and weight of edges
     count_links(G);
-    caclulate_weights(G);
+    if (weighted) caclulate_weights(G);
     return G;
 }
 
-//add all the edges starting from "vert" into G
-void get_links(graph G, char* vert) {
-
-    // Get all the outgoing links from the file vert
-    Rep list = read_links(vert);
+//compare the 'top' most important urls by two rank vectors, reporting the result on stderr
+int compare_top(graph G, double* weights, double* exact, int top) {
+    if (top > G->nV) top = G->nV;
+    double* first = malloc(sizeof(double) * (G->nV > 0 ? G->nV : 1));
+    double* second = malloc(sizeof(double) * (G->nV > 0 ? G->nV : 1));
+    assert(first && second);
+    double largest = 0;
+    for (int i = 0; i < G->nV; i++) {
+        first[i] = weights[i];
+        second[i] = exact[i];
+        if (fabs(weights[i]-exact[i]) > largest) largest = fabs(weights[i]-exact[i]);
+    }
+    int* order = generate_sorted_indexes(G, first, top);
+    int* exact_order = generate_sorted_indexes(G, second, top);
 
-    // Add edges into the graph g
-    for (Data curr = list->data_list; curr != NULL; curr = curr->next) {
-        add_edge(G,vert,curr->info);
+    int mismatch = -1;
+    for (int i = 0; i < top && mismatch == -1; i++) {
+        if (order[i] != exact_order[i]) mismatch = i;
+    }
+    if (mismatch == -1) {
+        fprintf(stderr,"float: the top %d urls match the double run (largest difference %.3g)\n",top,largest);
+    } else {
+        fprintf(stderr,"float: the top %d urls differ from the double run at position %d (%s, %.10f instead of %s, %.10f)\n",
+                top,mismatch+1,G->map[order[mismatch]],first[mismatch],G->map[exact_order[mismatch]],second[mismatch]);
     }
 
-    free_rep(list);
+    free(first);
+    free(second);
+    free(order);
+    free(exact_order);
+    return mismatch == -1 ? 0 : 1;
 }
 
-// calculate the weights of each of the edges in the graph by the Pagerank algorithm
-double* generate_weights(graph G, double damping_factor, double min_diff, int max_iterations) {
-	int size = G->nV;
+//rank from an edge stream file, building it from the url files first if it is missing or out of date
+void stream_pagerank(struct options opts, double damping_factor, double min_diff, int max_iterations) {
+    struct stage_timer timer = start_stage("load");
+    edge_stream s = open_edge_stream(opts.stream, 1);
+    if (s == NULL) {
+        build_edge_stream(opts.stream);
+        s = open_edge_stream(opts.stream, 0);
+        assert(s);
+    }
+    stop_stage(timer);
 
-    // Declare two arrays of type double
-    double* new_rank = malloc(sizeof(double)*size);
-    double* old_rank = malloc(sizeof(double)*size);
-    
-    // The initial value of the pagerank should equal to 1 divided by the number of URLs
-    for(int i = 0; i < size; i++) old_rank[i] = 1.0/size;
+    timer = start_stage("solve");
+    int iterations = 0;
+    double* weights = stream_weights(s, damping_factor, min_diff, max_iterations, &iterations);
+    stop_stage(timer);
+    if (opts.verbose) fprintf(stderr,"stream: %d iterations, %ld edges read\n",iterations,(long)iterations*s->nE);
 
+    graph G = stream_vertices(s);
+    int top = opts.top >= 0 && opts.top < G->nV ? opts.top : G->nV;
+    timer = start_stage("write");
+    write_ranking(G, weights, top, "pagerankList.txt");
+    stop_stage(timer);
+    free(weights);
+    drop_graph(G);
+    close_edge_stream(s);
+}
 
+//rank every damping factor in the comma separated list, writing each ranking to pagerankList-<factor>.txt
+void rank_dampings(graph G, char* list, double min_diff, int max_iterations, int top, int verbose, int* order) {
+    double dampings[MAX_DAMPINGS];
     int count = 0;
-    
-    // While the limit of iterations has not been reached, continue to iterate and compute the pagerank values
-    while (count < max_iterations) {
-        for (int vert = 0; vert < size; vert++) {
-            new_rank[vert] = (1-damping_factor)/size;
-            for (int from = 0; from < size; from++) {
-                if (G->arr[from][vert] != 0) {
-                    new_rank[vert] += damping_factor*G->arr[from][vert]*old_rank[from];
-                }
-            }  
+    for (char* factor = strtok(list, ","); factor != NULL; factor = strtok(NULL, ",")) {
+        char* end = NULL;
+        double d = strtod(factor, &end);
+        if (count == MAX_DAMPINGS || end == factor || *end != '\0' || d < 0 || d >= 1) {
+            fprintf(stderr,"Bad damping factor list (at most %d factors, each in [0, 1))\n",MAX_DAMPINGS);
+            abort();
         }
-        
-        // While the difference is still greater than the minimum suggested value, continue to compute the pagerank values
-        double diff = 0;
-        for(int i = 0; i < size; i++) diff += fabs(old_rank[i]-new_rank[i]);
-        if (diff < min_diff) {
-            break;
+        // Two spellings of one factor (0.85 and 0.850) would rank it twice into the same file
+        for (int c = 0; c < count; c++) {
+            if (dampings[c] == d) {
+                fprintf(stderr,"Damping factor %s is given more than once\n",factor);
+                abort();
+            }
         }
-        for(int i = 0; i < size; i++) old_rank[i] = new_rank[i];
-        count++;
+        dampings[count++] = d;
     }
-    
-    free(old_rank);
-	return new_rank;
+    if (count == 0) abort();
+
+    int iterations[MAX_DAMPINGS];
+    double** ranks = batched_weights(G, dampings, count, min_diff, max_iterations, iterations);
+    if (order != NULL) restore_order(G, order, NULL);
+
+    char name[64];
+    for (int c = 0; c < count; c++) {
+        if (order != NULL) restore_ranks(G, order, ranks[c]);
+        damping_file_name(dampings[c], name, sizeof(name));
+        if (verbose) fprintf(stderr,"batched %s: %d iterations\n",name,iterations[c]);
+        write_ranking(G, ranks[c], top, name);
+        free(ranks[c]);
+    }
+    free(ranks);
 }
 
-//return a list of indexes which ranks the vertices by their importance
-int* generate_sorted_indexes(graph G, double* weights) {
-	int* indexes = malloc(sizeof(int)*G->nV);
-	assert(indexes);
-    for(int i = 0; i < G->nV; i++) indexes[i] = i;
-
-    //simple bubble sort - sort indexes based on their weights
-    int sorted = 0;
-    int upto = G->nV;
-    while (!sorted) {
-        sorted = 1;
-        upto--;
-        for(int i = 0; i < upto; i++) {
-            //sort by weights or by alphabetic order if weights are very close (don't check equality of double values using ==)
-            if (weights[i] < weights[i+1] || 
-                (fabs(weights[i] - weights[i+1]) < 0.0000000001 && strcmp(G->map[indexes[i]],G->map[indexes[i+1]]) > 0)) {
-                double temp = weights[i];
-                weights[i] = weights[i+1];
-                weights[i+1] = temp;
-                int i_temp = indexes[i];
-                indexes[i] = indexes[i+1];
-                indexes[i+1] = i_temp;
-                sorted = 0;
-           }
+//write the name of the ranking file of a damping factor, pagerankList-<factor>.txt, into name
+//the factor is written from its value with the fewest significant digits that read back as the same
+//double, so every spelling of a factor names the same file and different factors never share one
+void damping_file_name(double damping_factor, char* name, int size) {
+    for (int digits = 1; digits <= 17; digits++) {
+        int length = snprintf(name, size, "pagerankList-%.*g.txt", digits, damping_factor);
+        if (length < 0 || length >= size) {
+            fprintf(stderr,"Damping factor %.17g does not fit in a file name\n",damping_factor);
+            abort();
         }
+        if (strtod(name + strlen("pagerankList-"), NULL) == damping_factor) return;
     }
-    return indexes;
 }
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "graph.h"
+#include "threads.h"
+#include "kernel.h"
+#include "parallel_rank.h"
+
+//Parallel Pagerank iteration
+//the worker threads are started once and each owns a chunk of vertices for every iteration
+//an iteration is one pull kernel call over the chunk, giving a partial L1 diff, and a single barrier
+//after the barrier every thread adds the partial diffs in the same order, so they all reach the
+//same decision to stop, and each swaps its own old/new rank pointers instead of copying the vector
+//the partial diffs are double buffered by iteration parity so a fast thread can not overwrite a
+//value a slow thread is still reading
+
+struct rank_job {
+    graph G;
+    double damping_factor;
+    double min_diff;
+    int max_iterations;
+    int threads;
+    int* chunk_start;
+    double* scaled;
+    pull_kernel pull;
+    double* ranks[2];
+    double* partial_diff[2];
+    barrier iteration_done;
+    double* result;
+    int iterations;
+};
+
+
+
+//helper functions//
+
+
+//run the Pagerank iterations over one chunk of vertices
+static void rank_worker(int id, void* arg) {
+    struct rank_job* job = arg;
+    graph G = job->G;
+    double teleport = (1-job->damping_factor)/G->nV;
+    double* old_rank = job->ranks[0];
+    double* new_rank = job->ranks[1];
+    int first = job->chunk_start[id];
+    int last = job->chunk_start[id+1];
+
+    int count = 0;
+    int converged = 0;
+    while (count < job->max_iterations) {
+        job->partial_diff[count % 2][id] = job->pull(G, job->scaled, teleport, old_rank, new_rank, first, last);
+        barrier_wait(&job->iteration_done);
+
+        double total = 0;
+        for (int t = 0; t < job->threads; t++) total += job->partial_diff[count % 2][t];
+        if (total < job->min_diff) {
+            converged = 1;
+            count++;
+            break;
+        }
+        double* temp = old_rank;
+        old_rank = new_rank;
+        new_rank = temp;
+        count++;
+    }
+
+    // The latest ranks are in new_rank after converging and in old_rank after the last swap
+    if (id == 0) {
+        job->result = converged ? new_rank : old_rank;
+        job->iterations = count;
+    }
+}
+
+
+
+//split the vertices into 'threads' contiguous chunks holding roughly the same number of in-edges
+void balance_chunks(graph G, int threads, int* chunk_start) {
+    //the cost of the vertices before v is one per vertex plus one per in-edge, i.e. in_start[v] + v
+    long total = (long)G->nE + G->nV;
+    int vert = 0;
+    chunk_start[0] = 0;
+    for (int t = 1; t < threads; t++) {
+        long target = total * t / threads;
+        while (vert < G->nV && (long)G->in_start[vert] + vert < target) vert++;
+        chunk_start[t] = vert;
+    }
+    chunk_start[threads] = G->nV;
+}
+
+//calculate the weights of each of the edges in the graph by the Pagerank algorithm, sharing every
+//iteration between 'threads' worker threads, and store the number of iterations made in *iterations
+double* parallel_generate_weights(graph G, double damping_factor, double min_diff, int max_iterations, int threads, int* iterations) {
+    int size = G->nV;
+    if (threads < 1) threads = 1;
+
+    struct rank_job job;
+    job.G = G;
+    job.damping_factor = damping_factor;
+    job.min_diff = min_diff;
+    job.max_iterations = max_iterations;
+    job.threads = threads;
+    job.chunk_start = malloc(sizeof(int) * (threads + 1));
+    job.ranks[0] = malloc(sizeof(double) * (size > 0 ? size : 1));
+    job.ranks[1] = malloc(sizeof(double) * (size > 0 ? size : 1));
+    job.partial_diff[0] = malloc(sizeof(double) * threads);
+    job.partial_diff[1] = malloc(sizeof(double) * threads);
+    assert(job.chunk_start && job.ranks[0] && job.ranks[1] && job.partial_diff[0] && job.partial_diff[1]);
+
+    // The initial value of the pagerank should equal to 1 divided by the number of URLs
+    for (int i = 0; i < size; i++) job.ranks[0][i] = 1.0/size;
+
+    job.scaled = scale_weights(G, damping_factor);
+    job.pull = select_pull_kernel();
+    balance_chunks(G, threads, job.chunk_start);
+    barrier_init(&job.iteration_done, threads);
+    run_threads(threads, rank_worker, &job);
+    barrier_destroy(&job.iteration_done);
+
+    free(job.result == job.ranks[0] ? job.ranks[1] : job.ranks[0]);
+    *iterations = job.iterations;
+    free(job.scaled);
+    free(job.chunk_start);
+    free(job.partial_diff[0]);
+    free(job.partial_diff[1]);
+    return job.result;
+}
@@ -0,0 +1,14 @@
+#ifndef PARALLEL_RANK_H
+#define PARALLEL_RANK_H
+
+#include "graph.h"
+
+//split the vertices into 'threads' contiguous chunks holding roughly the same number of in-edges
+//chunk t covers the vertices chunk_start[t] .. chunk_start[t+1]-1, chunk_start needs threads+1 entries
+void balance_chunks(graph G, int threads, int* chunk_start);
+
+//calculate the weights of each of the edges in the graph by the Pagerank algorithm, sharing every
+//iteration between 'threads' worker threads, and store the number of iterations made in *iterations
+double* parallel_generate_weights(graph G, double damping_factor, double min_diff, int max_iterations, int threads, int* iterations);
+
+#endif
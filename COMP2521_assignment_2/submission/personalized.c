@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include "graph.h"
+#include "kernel.h"
+#include "personalized.h"
+
+//Personalized Pagerank
+//the global Pagerank returns (1-d)/nV of rank to every vertex each step, here the same (1-d) is
+//returned only to the seed vertices of a teleport vector, biasing the ranks towards their neighbourhood
+//the weighted graph is reused as it is, so one loaded graph can answer any number of seed sets
+//the push solver holds unpushed mass (the residual) per vertex; pushing a vertex keeps its residual
+//as rank and passes d*weight of it along each out-edge, so work is only done where mass arrives
+
+
+
+//parse a comma separated list of seed urls into a teleport vector over the vertices of G
+teleport parse_teleport(graph G, char* seeds) {
+    teleport t = malloc(sizeof(struct _teleport));
+    assert(t);
+    int cap = 1;
+    for (char* c = seeds; *c != '\0'; c++) if (*c == ',') cap++;
+    t->size = 0;
+    t->vertices = malloc(sizeof(int) * cap);
+    t->weights = malloc(sizeof(double) * cap);
+    assert(t->vertices && t->weights);
+
+    char* list = malloc(strlen(seeds) + 1);
+    assert(list);
+    strcpy(list, seeds);
+    for (char* url = strtok(list, ","); url != NULL; url = strtok(NULL, ",")) {
+        double weight = 1;
+        char* colon = strchr(url, ':');
+        if (colon != NULL) {
+            *colon = '\0';
+            weight = atof(colon + 1);
+        }
+        int id = vertex_ID(G, url);
+        if (id == -1 || !(weight > 0)) {
+            fprintf(stderr, "Invalid seed url or weight: %s\n", url);
+            abort();
+        }
+        t->vertices[t->size] = id;
+        t->weights[t->size] = weight;
+        t->size++;
+    }
+    free(list);
+    if (t->size == 0) {
+        fprintf(stderr, "No seed urls given\n");
+        abort();
+    }
+    return t;
+}
+
+//free all memory associated with the teleport vector
+void drop_teleport(teleport t) {
+    free(t->vertices);
+    free(t->weights);
+    free(t);
+}
+
+//return the dense teleport amount of every vertex, (1-d) shared in proportion to the seed weights
+static double* dense_teleport(graph G, double damping_factor, teleport t) {
+    double* jump = calloc(G->nV > 0 ? G->nV : 1, sizeof(double));
+    assert(jump);
+    double total = 0;
+    for (int i = 0; i < t->size; i++) total += t->weights[i];
+    for (int i = 0; i < t->size; i++) jump[t->vertices[i]] += (1-damping_factor)*t->weights[i]/total;
+    return jump;
+}
+
+//calculate personalized Pagerank over an already weighted graph
+double* personalized_weights(graph G, double damping_factor, double min_diff, int max_iterations,
+                             teleport t, int* iterations) {
+    int size = G->nV;
+    double* new_rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    double* old_rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    assert(new_rank && old_rank);
+    double* jump = dense_teleport(G, damping_factor, t);
+    double* scaled = scale_weights(G, damping_factor);
+
+    // Start from the teleport distribution itself, scaled to a total of 1
+    for (int i = 0; i < size; i++) old_rank[i] = jump[i]/(1-damping_factor);
+
+    int count = 0;
+    while (count < max_iterations) {
+        double diff = 0;
+        for (int vert = 0; vert < size; vert++) {
+            double rank = jump[vert];
+            for (int e = G->in_start[vert]; e < G->in_start[vert+1]; e++) {
+                rank += scaled[e]*old_rank[G->in_src[e]];
+            }
+            new_rank[vert] = rank;
+            diff += fabs(old_rank[vert]-rank);
+        }
+        count++;
+        if (diff < min_diff) break;
+        double* temp = old_rank;
+        old_rank = new_rank;
+        new_rank = temp;
+    }
+
+    *iterations = count;
+    free(jump);
+    free(scaled);
+    free(old_rank);
+    return new_rank;
+}
+
+//approximate personalized Pagerank by pushing rank mass outwards from the vertices of t
+double* personalized_push(graph G, double damping_factor, double tolerance, teleport t, long* pushes) {
+    int size = G->nV;
+    double* rank = calloc(size > 0 ? size : 1, sizeof(double));
+    double* residual = dense_teleport(G, damping_factor, t);
+    char* queued = calloc(size > 0 ? size : 1, sizeof(char));
+    //every vertex is in the queue at most once, so it never holds more than size entries
+    int* queue = malloc(sizeof(int) * (size > 0 ? size : 1));
+    assert(rank && queued && queue);
+    int head = 0;
+    int length = 0;
+
+    for (int i = 0; i < t->size; i++) {
+        int vert = t->vertices[i];
+        if (!queued[vert] && residual[vert] > tolerance) {
+            queued[vert] = 1;
+            queue[(head + length++) % size] = vert;
+        }
+    }
+
+    long count = 0;
+    while (length > 0) {
+        int vert = queue[head];
+        head = (head + 1) % size;
+        length--;
+        queued[vert] = 0;
+
+        // Keep the vertex's residual as rank and pass the damped share of it along every out-edge
+        double mass = residual[vert];
+        residual[vert] = 0;
+        rank[vert] += mass;
+        count++;
+        for (int e = G->out_start[vert]; e < G->out_start[vert+1]; e++) {
+            int dest = G->out_dest[e];
+            residual[dest] += damping_factor*G->out_weight[e]*mass;
+            if (!queued[dest] && residual[dest] > tolerance) {
+                queued[dest] = 1;
+                queue[(head + length++) % size] = dest;
+            }
+        }
+    }
+
+    *pushes = count;
+    free(residual);
+    free(queued);
+    free(queue);
+    return rank;
+}
@@ -0,0 +1,34 @@
+#ifndef PERSONALIZED_H
+#define PERSONALIZED_H
+
+#include "graph.h"
+
+//a sparse teleport vector: the vertices random jumps land on, and their relative weights
+typedef struct _teleport {
+    int size;
+    int* vertices;
+    double* weights;
+} *teleport;
+
+//parse a comma separated list of seed urls, each optionally followed by ":weight" (default 1),
+//into a teleport vector over the vertices of G
+//aborts if a url is not a vertex of G or a weight is not positive
+teleport parse_teleport(graph G, char* seeds);
+
+//free all memory associated with the teleport vector
+void drop_teleport(teleport t);
+
+//calculate personalized Pagerank over an already weighted graph: random jumps return to the vertices
+//of t (in proportion to their weights) instead of to every vertex uniformly
+//iterates like generate_weights and stores the number of iterations made in *iterations
+double* personalized_weights(graph G, double damping_factor, double min_diff, int max_iterations,
+                             teleport t, int* iterations);
+
+//approximate personalized Pagerank by pushing rank mass outwards from the vertices of t, only
+//touching vertices that mass reaches
+//stops once no vertex holds more than 'tolerance' unpushed mass, the L1 error is then at most the
+//total unpushed mass divided by (1 - damping_factor)
+//stores the number of pushes made in *pushes
+double* personalized_push(graph G, double damping_factor, double tolerance, teleport t, long* pushes);
+
+#endif
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "graph.h"
+#include "kernel.h"
+#include "push.h"
+
+//Residual push Pagerank
+//the ranks start uniform, as in generate_weights, and one pull over the in-edges gives every
+//vertex's residual; from then on pushing a vertex adds its residual to its rank and passes d*weight
+//of it to each out-neighbour's residual, which keeps residual = teleport + pull - rank true everywhere
+//vertices whose residual is already small are never touched again, so on skewed graphs most of the
+//work goes to the few vertices that are still moving
+//the work list is a FIFO queue holding each vertex at most once
+
+
+
+//calculate the Pagerank of every vertex with an asynchronous residual push solver
+double* push_weights(graph G, double damping_factor, double min_diff, int max_iterations, long* pushes, long* edges) {
+    int size = G->nV;
+    double* rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    double* residual = malloc(sizeof(double) * (size > 0 ? size : 1));
+    char* queued = calloc(size > 0 ? size : 1, sizeof(char));
+    int* queue = malloc(sizeof(int) * (size > 0 ? size : 1));
+    assert(rank && residual && queued && queue);
+    for (int i = 0; i < size; i++) rank[i] = 1.0/size;
+
+    // One pull gives the residual of the starting ranks
+    double* scaled = scale_weights(G, damping_factor);
+    pull_scalar(G, scaled, (1-damping_factor)/size, rank, residual, 0, size);
+    free(scaled);
+    double threshold = min_diff/size;
+    int head = 0;
+    int length = 0;
+    for (int i = 0; i < size; i++) {
+        residual[i] -= rank[i];
+        if (fabs(residual[i]) > threshold) {
+            queued[i] = 1;
+            queue[length++] = i;
+        }
+    }
+
+    long count = 0;
+    long visited = G->nE;
+    long limit = (long)max_iterations * size;
+    while (length > 0 && count < limit) {
+        int vert = queue[head];
+        head = (head + 1) % size;
+        length--;
+        queued[vert] = 0;
+
+        double mass = residual[vert];
+        residual[vert] = 0;
+        rank[vert] += mass;
+        count++;
+        visited += G->out_start[vert+1] - G->out_start[vert];
+        for (int e = G->out_start[vert]; e < G->out_start[vert+1]; e++) {
+            int dest = G->out_dest[e];
+            residual[dest] += damping_factor*G->out_weight[e]*mass;
+            if (!queued[dest] && fabs(residual[dest]) > threshold) {
+                queued[dest] = 1;
+                queue[(head + length++) % size] = dest;
+            }
+        }
+    }
+
+    *pushes = count;
+    *edges = visited;
+    free(residual);
+    free(queued);
+    free(queue);
+    return rank;
+}
@@ -0,0 +1,13 @@
+#ifndef PUSH_H
+#define PUSH_H
+
+#include "graph.h"
+
+//calculate the Pagerank of every vertex with an asynchronous residual push solver
+//each vertex keeps the residual r = (1-d)/nV + (pull of the ranks) - rank, which is exactly the change
+//one Jacobi step would make to it; only vertices with a residual above min_diff/nV are pushed, so the
+//result meets the same tolerance as generate_weights (the L1 norm of the residual is below min_diff)
+//at most max_iterations*nV pushes are made; the pushes and edges visited are stored in *pushes and *edges
+double* push_weights(graph G, double damping_factor, double min_diff, int max_iterations, long* pushes, long* edges);
+
+#endif
@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include "graph.h"
+#include "ranking.h"
+#include "instrument.h"
+
+//Ranking
+//the most important urls are found with a heap of the best 'top' seen so far when only some are
+//wanted, and with qsort when all of them are
+
+
+
+//order vertices by weight (descending), and by alphabetic order if their weights print the same
+//the weights are compared as rounded to the 7 decimals written, rather than as "within 1e-10",
+//so that the order is total and does not depend on how qsort or the heap visit the vertices
+static int compare_ranked(const void* a, const void* b) {
+    const struct ranked* x = a;
+    const struct ranked* y = b;
+    if (x->printed != y->printed) return x->printed < y->printed ? 1 : -1;
+    return strcmp(x->url, y->url);
+}
+
+//restore the heap below 'pos', where every parent orders after (is worse than) its children
+static void sift_down(struct ranked* heap, int size, int pos) {
+    while (1) {
+        int worst = pos;
+        int left = 2*pos + 1;
+        int right = left + 1;
+        if (left < size && compare_ranked(&heap[left], &heap[worst]) > 0) worst = left;
+        if (right < size && compare_ranked(&heap[right], &heap[worst]) > 0) worst = right;
+        if (worst == pos) return;
+        struct ranked temp = heap[pos];
+        heap[pos] = heap[worst];
+        heap[worst] = temp;
+        pos = worst;
+    }
+}
+
+//return a list of the indexes of the 'top' most important vertices, in order of importance
+//weights is reordered to match, so weights[i] is the weight of the i-th returned index
+int* generate_sorted_indexes(graph G, double* weights, int top) {
+    if (top > G->nV) top = G->nV;
+    struct ranked* ranks = malloc(sizeof(struct ranked)*(G->nV > 0 ? G->nV : 1));
+    assert(ranks);
+    for(int i = 0; i < G->nV; i++) {
+        ranks[i].weight = weights[i];
+        ranks[i].printed = llround(weights[i]*1e7);
+        ranks[i].url = G->map[i];
+        ranks[i].index = i;
+    }
+
+    if (top < G->nV) {
+        // Keep the best 'top' vertices seen so far in a heap whose root is the worst of them
+        for (int i = top/2 - 1; i >= 0; i--) sift_down(ranks, top, i);
+        for (int i = top; i < G->nV; i++) {
+            if (top > 0 && compare_ranked(&ranks[i], &ranks[0]) < 0) {
+                ranks[0] = ranks[i];
+                sift_down(ranks, top, 0);
+            }
+        }
+    }
+    qsort(ranks, top, sizeof(struct ranked), compare_ranked);
+
+	int* indexes = malloc(sizeof(int)*(top > 0 ? top : 1));
+	assert(indexes);
+    for(int i = 0; i < top; i++) {
+        indexes[i] = ranks[i].index;
+        weights[i] = ranks[i].weight;
+    }
+    free(ranks);
+    return indexes;
+}
+
+//sort the weights and write the 'top' most important urls to the file 'name'
+void write_ranking(graph G, double* weights, int top, char* name) {
+    int* sorted_indexes = generate_sorted_indexes(G, weights, top);
+    FILE* output = counted_fopen(name,"w");
+    assert(output);
+
+    // Write the url, the number of outlinks and the weighted pagerank into the opened file
+    for(int i = 0; i < top; i++) {
+        int index = sorted_indexes[i];
+        fprintf(output,"%s, %d, %.7lf\n",G->map[index],G->links[index].links_out,weights[i]);
+    }
+
+    free(sorted_indexes);
+    fclose(output);
+}
@@ -0,0 +1,22 @@
+#ifndef RANKING_H
+#define RANKING_H
+
+#include "graph.h"
+
+//a vertex and its weight, as compared when ranking
+struct ranked {
+    double weight;
+    long long printed;  //weight in units of the last decimal written (1e-7)
+    char* url;
+    int index;
+};
+
+//return a list of the indexes of the 'top' most important vertices, in order of importance
+//weights is reordered to match, so weights[i] is the weight of the i-th returned index
+int* generate_sorted_indexes(graph G, double* weights, int top);
+
+//sort the weights and write the 'top' most important urls to the file 'name'
+//as "url, outlinks, rank" lines
+void write_ranking(graph G, double* weights, int top, char* name);
+
+#endif
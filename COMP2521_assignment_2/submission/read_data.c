@@ -3,69 +3,63 @@
 #include <assert.h>
 #include <string.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "read_data.h"
+#include "instrument.h"
+
+// Url files of at least this many bytes are mapped rather than read
+#define MAP_THRESHOLD (64 * 1024)
 
-Data new_data(char *str);
-Data last_node(Data list);
-char *normalise(char *str);
 Rep new_rep(void);
 Content new_content(char *str);
+int scan_word(FILE *fp, char **word);
+char *read_file(int fd, size_t size);
+struct source_stamp stamp_of(struct stat *info);
+void add_token(struct token **tokens, int *size, int *cap, char *str, int length);
+void add_url(Content content, char *url);
+int normalise_token(char *str, int length);
+char *split_section(UrlFile file, char *p, char *end, char number);
+unsigned hash_word(char *str, int length);
+int find_slot(Document doc, char *str, int length, unsigned hash);
 
-// Create a new node of type struct data. The argument has been dynamically
-// allocated and will need to be freed manually by the user after reading from a txt file.
-Data new_data(char *str)
-{
-    assert(str != NULL);
-    Data new = malloc(sizeof(struct data));
-    assert(new != NULL);
-    new->info = str;
-    new->next = NULL;
-    return new;
-}
-
-// Return the last node of a linked list of type struct data.
-Data last_node(Data list)
+// Read a file of 'size' bytes into a new buffer with one spare byte after it
+char *read_file(int fd, size_t size)
 {
-    assert(list != NULL);
-    Data last;
-    for (last = list; last->next != NULL; last = last->next)
+    char *text = counted_malloc(size + 1);
+    assert(text != NULL);
+    size_t done = 0;
+    while (done < size)
     {
+        ssize_t got = read(fd, text + done, size - done);
+        assert(got > 0);
+        done += got;
     }
-    return last;
+    text[size] = '\0';
+    return text;
 }
 
-// Normalise a given string. This will require making all letters lower case and removing
-// the last character if it is a (.), (,), (;) or (?)
-char *normalise(char *str)
+// Stamp a file from the status of its open descriptor
+struct source_stamp stamp_of(struct stat *info)
 {
-    assert(str != NULL);
-    int i = 0;
-    // Check the last character to see if it is an invalid punctuation mark
-    int end = strlen(str) - 1;
-    if ((str[end] == '.') || (str[end] == ',') || (str[end] == ';') || (str[end] == '?'))
-    {
-        str[end] = '\0';
-    }
-
-    // Iterate through the string and change any upper case characters to a lower case variant. 
-    for (; i < strlen(str); ++i)
-    {
-        if (isupper(str[i]))
-        {
-            str[i] = tolower(str[i]);
-        }
-    }
-    return str;
+    struct source_stamp stamp;
+    stamp.size = info->st_size;
+    stamp.seconds = info->st_mtim.tv_sec;
+    stamp.nanoseconds = info->st_mtim.tv_nsec;
+    return stamp;
 }
 
-// Create a data structure that will hold a linked list and also the number
-// of nodes in the linked list.
+// Create a data structure that will hold an empty, growable array of words
 Rep new_rep(void)
 {
-    Rep new = malloc(sizeof(struct data_rep));
+    Rep new = counted_malloc(sizeof(struct data_rep));
     assert(new != NULL);
-    new->data_list = NULL;
+    new->items = NULL;
     new->size = 0;
+    new->cap = 0;
+    new->text = NULL;
     return new;
 }
 
@@ -73,263 +67,372 @@ Rep new_rep(void)
 // Read URLs from collection.txt
 Rep read_collection(void)
 {
-    char *url; // Store the URLs that are read from collection.txt
-    Rep collection = new_rep(); // Will store a linked list of URLs that will form the vertices of the graph
-    FILE *fp = fopen("collection.txt\0", "r");
-    assert(fp != NULL);
+    Rep collection = new_rep(); // Will store an array of URLs that will form the vertices of the graph
+    int fd = open("collection.txt", O_RDONLY);
+    assert(fd >= 0);
+    count_event(COUNT_FILES_OPENED, 1);
+    struct stat info;
+    int status = fstat(fd, &info);
+    assert(status == 0);
+    collection->stamp = stamp_of(&info);
+    collection->text = read_file(fd, info.st_size);
+    close(fd);
+    count_event(COUNT_BYTES_PARSED, info.st_size);
 
-    while (fscanf(fp, "%ms", &url) == 1) // Continue to iterate through the file while URLs can be read
+    // Split the text into URLs, terminating each one in place
+    char *p = collection->text;
+    char *end = collection->text + info.st_size;
+    while (p < end)
     {
-        if (collection->data_list == NULL) // No linked list has been formed yet
+        while (p < end && isspace((unsigned char) *p))
         {
-            collection->data_list = new_data(url);
+            ++p;
         }
-        else // Append to the end of the existing linked list
+        if (p == end)
         {
-            last_node(collection->data_list)->next = new_data(url);
+            break;
+        }
+        char *url = p;
+        while (p < end && !isspace((unsigned char) *p))
+        {
+            ++p;
         }
-        ++collection->size;
+        add_token(&collection->items, &collection->size, &collection->cap, url, p - url);
+        *p++ = '\0';
     }
-
-    fclose(fp);
     return collection;
 }
 
-// Read outlinks from a url txt file.
-Rep read_links(char *source)
+// Append a token to a growable array of tokens
+void add_token(struct token **tokens, int *size, int *cap, char *str, int length)
 {
-    assert(source != NULL);
-    // Need enough memory for the size of the url + .txt\0
-    char *file_name = malloc(sizeof(char) * (strlen(source) + 5)); 
-    assert(file_name != NULL);
-    *file_name = '\0';
-    strcat(file_name, source);
-    strcat(file_name, ".txt\0");
+    if (*size == *cap)
+    {
+        *cap = *cap > 0 ? *cap * 2 : 16;
+        *tokens = realloc(*tokens, sizeof(struct token) * *cap);
+        assert(*tokens != NULL);
+        count_event(COUNT_ALLOCATIONS, 1);
+    }
+    (*tokens)[*size].str = str;
+    (*tokens)[*size].length = length;
+    ++*size;
+}
 
-    char *url = NULL;
-    // Store linked list of outlinks from a particular url
-    Rep url_outlinks = new_rep();
-    FILE *fp = fopen(file_name, "r");
-    assert(fp != NULL);
-    char buffer[17];
-    
-    // Continue searching through the file until finding start of outlinks
-    while (fgets(buffer, 17, fp))
+// Normalise a token in place and return its new length. This makes all letters lower case and
+// removes the last character if it is a (.), (,), (;) or (?)
+int normalise_token(char *str, int length)
+{
+    char last = str[length - 1];
+    if ((last == '.') || (last == ',') || (last == ';') || (last == '?'))
     {
-        if (strcmp(buffer, "#start Section-1") == 0)
-        {
-            break;
-        }
+        str[--length] = '\0';
+    }
+    for (int i = 0; i < length; ++i)
+    {
+        str[i] = tolower((unsigned char) str[i]);
     }
+    return length;
+}
 
-    while (fscanf(fp, "%ms", &url) == 1)
+// Split the section of a url file which starts at p into tokens, up to the
+// "#end Section-<number>" that closes it. Every token is terminated in place by overwriting
+// the whitespace after it. Returns the position after the closing marker.
+char *split_section(UrlFile file, char *p, char *end, char number)
+{
+    int cap = 0;
+    while (1)
     {
-        // Potential end of outlinks
-        if (strcmp(url, "#end") == 0) 
+        // Find the start and the end of the next token
+        while (p < end && isspace((unsigned char) *p))
+        {
+            ++p;
+        }
+        if (p == end)
         {
-            // Store the current position in the file
-            long pos = ftell(fp);
-            char *next = NULL;
-            // Check if the next term is Section-1
-            if (fscanf(fp, "%ms", &next) == 1)
+            return end;
+        }
+        char *start = p;
+        while (p < end && !isspace((unsigned char) *p))
+        {
+            ++p;
+        }
+        int length = p - start;
+
+        // Potential end of the section, which needs the next token to be Section-<number>
+        if (length == 4 && memcmp(start, "#end", 4) == 0)
+        {
+            char *next = p;
+            while (next < end && isspace((unsigned char) *next))
             {
-                // If so, the end of the url outlinks has been reached
-                if (strcmp(next, "Section-1") == 0)
-                {
-                    free(next);
-                    free(url);
-                    break;
-                }
-                // Otherwise, there are more URLs to be read
-                // No linked list has been formed yet
-                if (url_outlinks->data_list == NULL) 
-                {
-                    url_outlinks->data_list = new_data(url);
-                }
-                else // Append to the end of the existing linked list
-                {
-                    last_node(url_outlinks->data_list)->next = new_data(url);
-                }
-                ++url_outlinks->size;
-                // Reset the file position to immediately after finding the word
-                free(next);
-                fseek(fp, pos, SEEK_SET);
-                continue;
+                ++next;
             }
-            // fscanf has failed to read in another string
-            else
+            // The file ends after #end
+            if (next == end)
             {
-                free(url);
-                break;
+                return end;
             }
-
+            char *next_end = next;
+            while (next_end < end && !isspace((unsigned char) *next_end))
+            {
+                ++next_end;
+            }
+            if (next_end - next == 9 && memcmp(next, "Section-", 8) == 0 && next[8] == number)
+            {
+                return next_end;
+            }
+            // Otherwise #end is an ordinary token
         }
 
-        // No linked list has been formed yet
-        if (url_outlinks->data_list == NULL)
+        // p is whitespace or the spare byte after the file, either can hold the terminator
+        *p = '\0';
+        if (p < end)
+        {
+            ++p;
+        }
+        if (number == '1')
         {
-            url_outlinks->data_list = new_data(url);
+            add_token(&file->links, &file->n_links, &cap, start, length);
+            continue;
         }
-        // Append to the end of the existing linked list
-        else        
+        // Words are normalised, and dropped if nothing is left of them
+        length = normalise_token(start, length);
+        if (length > 0)
         {
-            last_node(url_outlinks->data_list)->next = new_data(url);
+            add_token(&file->words, &file->n_words, &cap, start, length);
         }
-        ++url_outlinks->size;
     }
-    fclose(fp);
-    free(file_name);
-    return url_outlinks;
 }
 
-// Read data from a URL text file
-Rep read_data(char *source)
+// Load the url.txt file of a url and split both of its sections into tokens, without
+// allocating memory for each token
+UrlFile open_url_file(char *source)
 {
     assert(source != NULL);
     // Need enough memory for the size of the url + .txt\0
-    char *file_name = malloc(sizeof(char) * (strlen(source) + 5)); 
+    char *file_name = counted_malloc(sizeof(char) * (strlen(source) + 5));
     assert(file_name != NULL);
     *file_name = '\0';
     strcat(file_name, source);
     strcat(file_name, ".txt\0");
 
-    char *word = NULL;
-    Rep words_rep = new_rep();
-    FILE *fp = fopen(file_name, "r");
-    assert(fp != NULL);
-    char buffer[17]; 
- 
-    // Continue searching through the file until finding start of section 2 
-    while (fgets(buffer, 17, fp))
+    int fd = open(file_name, O_RDONLY);
+    assert(fd >= 0);
+    count_event(COUNT_FILES_OPENED, 1);
+    struct stat info;
+    int status = fstat(fd, &info);
+    assert(status == 0);
+
+    UrlFile file = counted_malloc(sizeof(struct url_file));
+    assert(file != NULL);
+    file->size = info.st_size;
+    file->stamp = stamp_of(&info);
+    file->mapped = file->size >= MAP_THRESHOLD;
+    if (file->mapped)
     {
-        if (strcmp(buffer, "#start Section-2") == 0)
-        {
-            break;
-        }
+        // Reserve one byte more than the file so that a token at the very end can still be
+        // terminated, then map the file privately over the start of the reservation (the file
+        // itself is never written)
+        file->text = mmap(NULL, file->size + 1, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        assert(file->text != MAP_FAILED);
+        void *mapped = mmap(file->text, file->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        assert(mapped != MAP_FAILED);
     }
-
-    while (fscanf(fp, "%ms", &word) == 1)
+    else
     {
-        // Potential end of section 2
-        if (strcmp(word, "#end") == 0) 
-        {
-            // Store the position in the file
-            long pos = ftell(fp);
-            char *next = NULL;
-            // Check if the next term is Section-2
-            if (fscanf(fp, "%ms", &next) == 1)
-            {
-                // If so, the end of the relevant data section has been reached
-                if (strcmp(next, "Section-2") == 0)
-                {
-                    free(next);
-                    free(word);
-                    break;
-                }
-                // Else, append word onto the linked list of found terms
-                // It is not necessary to check if the length is 0 as normalising will not affect the length
-                word = normalise(word);
-                if (words_rep->data_list == NULL) // No linked list has been formed yet
-                {
-                    words_rep->data_list = new_data(word);
-                }
-                else // Append to the end of the existing linked list
-                {
-                    last_node(words_rep->data_list)->next = new_data(word);
-                }   
-                ++words_rep->size;
-                // Reset the file position to immediately after finding word
-                free(next);
-                fseek(fp, pos, SEEK_SET);
-                continue;
-            }
-            else
-            {
-                free(word);
-                break;
-            }
+        file->text = read_file(fd, file->size);
+    }
+    close(fd);
+    count_event(COUNT_BYTES_PARSED, file->size);
+    file->links = NULL;
+    file->n_links = 0;
+    file->words = NULL;
+    file->n_words = 0;
 
-        }
-        word = normalise(word);
-        if (strlen(word) == 0)
+    // Look for the '#' of each "#start Section-<number>" at the start of a line and split the
+    // section after it, so both sections come from one pass whatever order they are in
+    char *p = file->text;
+    char *end = file->text + file->size;
+    int found[2] = {0, 0};
+    while (p < end && !(found[0] && found[1]))
+    {
+        p = memchr(p, '#', end - p);
+        if (p == NULL)
         {
-            free(word);
-            continue;
+            break;
         }
-        if (words_rep->data_list == NULL) // No linked list has been formed yet
+        int marker = end - p >= 16 && (p == file->text || p[-1] == '\n') &&
+                     memcmp(p, "#start Section-", 15) == 0 && (p[15] == '1' || p[15] == '2');
+        if (marker && !found[p[15] - '1'])
         {
-            words_rep->data_list = new_data(word);
+            found[p[15] - '1'] = 1;
+            p = split_section(file, p + 16, end, p[15]);
         }
-        else // Append to the end of the existing linked list
+        else
         {
-            last_node(words_rep->data_list)->next = new_data(word);
+            ++p;
         }
-        ++words_rep->size;
     }
     free(file_name);
-    fclose(fp);
-    return words_rep;
+    return file;
 }
 
-// Return a count for the instances of a word in a url.txt file
-int count_instances(Data words, char *str)
+// Release a url file, its tokens can no longer be used
+void close_url_file(UrlFile file)
 {
-    Data curr = words;
-    int count = 0;
-    while (curr != NULL)
+    assert(file != NULL);
+    if (file->mapped)
     {
-        if (strcmp(curr->info, str) == 0)
+        munmap(file->text, file->size + 1);
+    }
+    else
+    {
+        free(file->text);
+    }
+    free(file->links);
+    free(file->words);
+    free(file);
+}
+
+// FNV-1a hash of a word
+unsigned hash_word(char *str, int length)
+{
+    unsigned hash = 2166136261u;
+    for (int i = 0; i < length; ++i)
+    {
+        hash = (hash ^ (unsigned char) str[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Return the slot of a document's hash table which holds the word, or the empty slot where it
+// would be added
+int find_slot(Document doc, char *str, int length, unsigned hash)
+{
+    int mask = doc->slots_cap - 1;
+    int slot = hash & mask;
+    while (doc->slots[slot] != -1)
+    {
+        struct term *term = &doc->terms[doc->slots[slot]];
+        if (term->length == length && memcmp(term->str, str, length) == 0)
         {
-            ++count;
+            break;
         }
-        curr = curr->next;
+        slot = (slot + 1) & mask;
     }
-    return count;
+    return slot;
 }
 
-// Free the linked list of Data nodes
-void free_data(Data head)
+// Read the url.txt file of a url once for its links, words and term frequencies
+Document read_document(char *source)
 {
-    Data curr = head;
-    while (curr != NULL)
+    Document doc = counted_malloc(sizeof(struct document));
+    assert(doc != NULL);
+    doc->file = open_url_file(source);
+    doc->n_words = doc->file->n_words;
+    doc->n_terms = 0;
+
+    // There are at most n_words terms, keep the table at most half full
+    doc->slots_cap = 8;
+    while (doc->slots_cap < 2 * doc->n_words)
     {
-        Data delete = curr;
-        curr = curr->next;
-        free(delete->info);
-        free(delete);
+        doc->slots_cap *= 2;
+    }
+    doc->terms = counted_malloc(sizeof(struct term) * (doc->n_words > 0 ? doc->n_words : 1));
+    doc->slots = counted_malloc(sizeof(int) * doc->slots_cap);
+    assert(doc->terms != NULL && doc->slots != NULL);
+    memset(doc->slots, -1, sizeof(int) * doc->slots_cap);
+
+    // Count each word, adding it as a term the first time it is seen
+    for (int i = 0; i < doc->n_words; ++i)
+    {
+        struct token *word = &doc->file->words[i];
+        int slot = find_slot(doc, word->str, word->length, hash_word(word->str, word->length));
+        if (doc->slots[slot] == -1)
+        {
+            doc->slots[slot] = doc->n_terms;
+            doc->terms[doc->n_terms].str = word->str;
+            doc->terms[doc->n_terms].length = word->length;
+            doc->terms[doc->n_terms].count = 0;
+            ++doc->n_terms;
+        }
+        ++doc->terms[doc->slots[slot]].count;
     }
-}    
+    return doc;
+}
 
-// Free the linked list of Dat + structure
+// Return the number of times word appears in a document (0 if it does not)
+int term_frequency(Document doc, char *word)
+{
+    int length = strlen(word);
+    int slot = find_slot(doc, word, length, hash_word(word, length));
+    return doc->slots[slot] == -1 ? 0 : doc->terms[doc->slots[slot]].count;
+}
+
+// Free a document, its links, words and terms can no longer be used
+void free_document(Document doc)
+{
+    assert(doc != NULL);
+    close_url_file(doc->file);
+    free(doc->terms);
+    free(doc->slots);
+    free(doc);
+}
+
+// Free the array of words + structure
 void free_rep(Rep rep)
 {
     assert(rep != NULL);
-    if (rep->size > 0)
-    {
-        free_data(rep->data_list);
-    }
+    free(rep->items);
+    free(rep->text);
     free(rep);
 }
 
 // Create a new Content node initialised to the str value
 Content new_content(char *str)
 {
-    Content new = malloc(sizeof(struct content_search));
+    Content new = counted_malloc(sizeof(struct content_search));
     assert(new != NULL);
     
     new->str = str;
     new->total = 0;
-    new->url_list = NULL;
+    new->urls = NULL;
+    new->cap = 0;
     new->next = NULL;
     return new;
 }
 
+// Append a URL to the growable array of a Content node
+void add_url(Content content, char *url)
+{
+    if (content->total == content->cap)
+    {
+        content->cap = content->cap > 0 ? content->cap * 2 : 8;
+        content->urls = realloc(content->urls, sizeof(char *) * content->cap);
+        assert(content->urls != NULL);
+        count_event(COUNT_ALLOCATIONS, 1);
+    }
+    content->urls[content->total++] = url;
+}
+
+// Read the next whitespace separated word of invertedIndex.txt into a newly allocated string.
+// Returns 1 if a word was read and 0 at the end of the file. Only search_index reads words
+// this way, url files are split in place by open_url_file.
+int scan_word(FILE *fp, char **word)
+{
+    if (fscanf(fp, "%ms", word) != 1)
+    {
+        return 0;
+    }
+    count_event(COUNT_ALLOCATIONS, 1);
+    return 1;
+}
+
 // Read invertedIndex.txt and form a linked list of found search terms and the 
 // URLs in which they were found. 
 Content search_index(int count, char **search_terms)
 {
     // Open invertedIndex.txt for reading
-    FILE *fp = fopen("invertedIndex.txt", "r");
+    FILE *fp = counted_fopen("invertedIndex.txt", "r");
     assert(fp != NULL);
     
     char *str = NULL;
@@ -340,36 +443,31 @@ Content search_index(int count, char **search_terms)
     while (i < count) 
     {
         // Could not find the search term in the invertedIndex.txt file
-        if (fscanf(fp, "%ms", &str) != 1)
+        if (!scan_word(fp, &str))
         {
             Content new = new_content(search_terms[i]);
             new->next = results;
             results = new;
             ++i;
-            rewind(fp);
+            counted_rewind(fp);
             continue;
         }
         // Have found a search term
         // Need to create a node in the linked list of Content nodes and prepend the result
-        if (strcmp(str, search_terms[i]) == 0)
+        if (counted_strcmp(str, search_terms[i]) == 0)
         {
             Content new = new_content(str);
             new->next = results;
             results = new;
             // It will be necessary now to continue searching through the file invertexIndex.txt
+            // A found term always has an array, even if no URLs follow it
+            results->cap = 8;
+            results->urls = counted_malloc(sizeof(char *) * results->cap);
+            assert(results->urls != NULL);
             char *url = NULL;
-            while (fscanf(fp, "%ms", &url) == 1) // Scan through and add URLs to the linked list 
+            while (scan_word(fp, &url)) // Scan through and add URLs to the array
             {
-
-                if (results->url_list == NULL)
-                {
-                    results->url_list = new_data(url);
-                }
-                else
-                {
-                    last_node(results->url_list)->next = new_data(url);
-                }
-                ++results->total;
+                add_url(results, url);
                 //see if we can find a newline character without running into another word
 				//if so, break
 				int c = fgetc(fp);
@@ -377,7 +475,7 @@ Content search_index(int count, char **search_terms)
 				if (c == '\n' || c == -1) break;
 				else ungetc(c, fp);
             }
-            rewind(fp);
+            counted_rewind(fp);
             ++i;
         }
         // If the search term cannot be found, free the memory allocated to the string
@@ -387,7 +485,7 @@ Content search_index(int count, char **search_terms)
         }
         // Reset the file pointer to the start of the file if a search term is not found
     }
-    fclose(fp);
+    counted_fclose(fp);
     return results;
 }
 
@@ -399,11 +497,15 @@ void free_search(Content head)
     {
         Content to_delete = curr;
         curr = curr->next;
-        // str has been dynamically allocated to the node in the linked list
-        if (to_delete->url_list != NULL)
+        // str and the URLs have been dynamically allocated if the term was found
+        if (to_delete->urls != NULL)
         {
             free(to_delete->str);
-            free_data(to_delete->url_list);
+            for (int i = 0; i < to_delete->total; ++i)
+            {
+                free(to_delete->urls[i]);
+            }
+            free(to_delete->urls);
         }
         free(to_delete);
     }
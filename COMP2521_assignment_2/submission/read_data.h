@@ -1,18 +1,31 @@
 #ifndef READ_H
 #define READ_H
 
-struct data
+// A word of a file read into memory. It points into the file's text, where it has been '\0'
+// terminated in place, and is only valid while the text is kept.
+struct token
 {
-    char *info;
-    struct data* next;
+    char *str;
+    int length;
 };
 
-typedef struct data* Data;
+// The size and modification time (to the nanosecond) of a file when it was opened, so that anything
+// built from the file can tell later whether it has changed since it was read
+struct source_stamp
+{
+    long long size;
+    long long seconds;
+    long long nanoseconds;
+};
 
+// A growable array of words, whose characters are all held in one block of text
 struct data_rep
 {
-    struct data* data_list;
+    struct token *items;
     int size;
+    int cap;
+    char *text;
+    struct source_stamp stamp; // The file the words were read from
 };
 
 typedef struct data_rep* Rep;
@@ -20,33 +33,77 @@ typedef struct data_rep* Rep;
 struct content_search
 {
     char *str;
-    int total;
-    struct data* url_list;
+    int total; // Number of URLs in urls
+    char **urls; // Growable array of the URLs that contain str, NULL if str was not found
+    int cap;
     struct content_search* next;
 };
 
 typedef struct content_search* Content;
 
+// A url file in memory with its outlinks (section 1) and its normalised words (section 2),
+// both found in a single pass over the file. Large files are mapped, small ones are read into
+// a buffer since mapping them costs more than copying them.
+struct url_file
+{
+    char *text; // The file, followed by one spare byte
+    size_t size;
+    struct source_stamp stamp; // Taken from the open file before any of it is read
+    int mapped; // Whether text is a mapping rather than an allocated buffer
+    struct token *links;
+    int n_links;
+    struct token *words;
+    int n_words;
+};
+
+typedef struct url_file* UrlFile;
+
+// A distinct word of a document and the number of times it appears
+struct term
+{
+    char *str; // Points into the document's text
+    int length;
+    int count;
+};
+
+// Everything needed from a url file by pagerank and the index: its links, its words and the
+// frequency of each distinct word, all from one read of the file
+struct document
+{
+    UrlFile file; // The links and the words in order, see open_url_file
+    int n_words; // Total number of words
+    struct term *terms; // Distinct words in order of first appearance
+    int n_terms;
+    int *slots; // Hash table from a word to its index in terms, -1 when the slot is empty
+    int slots_cap; // Always a power of two
+};
+
+typedef struct document* Document;
+
 // Read URLs from collection.txt to form the graph vertices
 Rep read_collection(void);
 
-// Read outlinks from a given url.txt file
-Rep read_links(char *source);
+// Load the url.txt file of a url and split both of its sections into tokens, without
+// allocating memory for each token
+UrlFile open_url_file(char *source);
+
+// Release a url file, its tokens can no longer be used
+void close_url_file(UrlFile file);
 
-// Read data from a url.txt file
-Rep read_data(char *source);
+// Read the url.txt file of a url once for its links, words and term frequencies
+Document read_document(char *source);
 
-// Return a count for the instances of a word in a url.txt file
-int count_instances(Data words, char *str);
+// Return the number of times word appears in a document (0 if it does not)
+int term_frequency(Document doc, char *word);
+
+// Free a document, its links, words and terms can no longer be used
+void free_document(Document doc);
 
 // Read URLs from the invertedIndex.txt file that match the search terms supplied as 
 // arguments
 Content search_index(int count, char **search_terms);
 
-// Free the linked list of Data nodes
-void free_data(Data head);
-
-// Free the linked list of Data + structure
+// Free the array of words + structure
 void free_rep(Rep rep);
 
 // Free the linked list of struct content_search nodes
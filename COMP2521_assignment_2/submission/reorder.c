@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "graph.h"
+#include "reorder.h"
+
+//Vertex reordering
+//vertex IDs follow collection.txt, so the sources pulled into one vertex are usually scattered over the
+//rank vector; renumbering the graph once it is built puts the ranks that are read together close
+//together, and the solvers run unchanged on the renumbered graph
+//the arrays are overwritten in place rather than replaced, so a graph mapped from a snapshot can be
+//reordered too (the mapping is private, the file is not changed)
+
+
+
+//helper functions//
+
+
+//the total degree of every vertex, for the comparisons below
+static int* degree_of;
+
+//order vertices by total degree (descending), then by ID so the order is stable
+static int compare_degree(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    int dx = degree_of[x];
+    int dy = degree_of[y];
+    if (dx != dy) return dx < dy ? 1 : -1;
+    return (x > y) - (x < y);
+}
+
+//order vertices by total degree (ascending), then by ID
+static int compare_degree_ascending(const void* a, const void* b) {
+    return -compare_degree(a, b);
+}
+
+//rebuild both edge layouts for the new numbering, the links of G must already be in the new order
+//the weights move too unless G was built without them
+//filling the columns while walking the old rows in the new order, and then the rows while walking
+//the new columns, leaves every row and column sorted without sorting
+static void permute_edges(graph G, int* order, int* position) {
+    int nV = G->nV;
+    int nE = G->nE;
+    int* old_start = malloc(sizeof(int) * (nV + 1));
+    int* old_dest = malloc(sizeof(int) * (nE > 0 ? nE : 1));
+    int weighted = G->out_weight != NULL;
+    double* old_weight = weighted ? malloc(sizeof(double) * (nE > 0 ? nE : 1)) : NULL;
+    int* cursor = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    assert(old_start && old_dest && (old_weight || !weighted) && cursor);
+    memcpy(old_start, G->out_start, sizeof(int) * (nV + 1));
+    memcpy(old_dest, G->out_dest, sizeof(int) * nE);
+    if (weighted) memcpy(old_weight, G->out_weight, sizeof(double) * nE);
+
+    G->out_start[0] = G->in_start[0] = 0;
+    for (int v = 0; v < nV; v++) {
+        G->out_start[v+1] = G->out_start[v] + G->links[v].links_out;
+        G->in_start[v+1] = G->in_start[v] + G->links[v].links_in;
+    }
+
+    // Columns from the old rows, taken in the new order of their sources
+    memcpy(cursor, G->in_start, sizeof(int) * nV);
+    for (int v = 0; v < nV; v++) {
+        int u = order[v];
+        for (int e = old_start[u]; e < old_start[u+1]; e++) {
+            int slot = cursor[position[old_dest[e]]]++;
+            G->in_src[slot] = v;
+            if (weighted) G->in_weight[slot] = old_weight[e];
+        }
+    }
+
+    // Rows from the new columns
+    memcpy(cursor, G->out_start, sizeof(int) * nV);
+    for (int v = 0; v < nV; v++) {
+        for (int e = G->in_start[v]; e < G->in_start[v+1]; e++) {
+            int slot = cursor[G->in_src[e]]++;
+            G->out_dest[slot] = v;
+            if (weighted) G->out_weight[slot] = G->in_weight[e];
+        }
+    }
+
+    free(old_start);
+    free(old_dest);
+    free(old_weight);
+    free(cursor);
+}
+
+//reverse Cuthill-McKee order: breadth first from a lowest degree vertex of every component, visiting
+//neighbours (in either direction) from the lowest degree up, then reversed
+static int* rcm_order(graph G) {
+    int nV = G->nV;
+    int* order = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    int* by_degree = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    int* neighbours = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    char* queued = calloc(nV > 0 ? nV : 1, sizeof(char));
+    assert(order && by_degree && neighbours && queued);
+    for (int v = 0; v < nV; v++) by_degree[v] = v;
+    qsort(by_degree, nV, sizeof(int), compare_degree_ascending);
+
+    int length = 0;
+    for (int s = 0; s < nV; s++) {
+        if (queued[by_degree[s]]) continue;
+        int head = length;
+        order[length++] = by_degree[s];
+        queued[by_degree[s]] = 1;
+        while (head < length) {
+            int vert = order[head++];
+            int found = 0;
+            for (int e = G->out_start[vert]; e < G->out_start[vert+1]; e++) {
+                if (!queued[G->out_dest[e]]) {
+                    queued[G->out_dest[e]] = 1;
+                    neighbours[found++] = G->out_dest[e];
+                }
+            }
+            for (int e = G->in_start[vert]; e < G->in_start[vert+1]; e++) {
+                if (!queued[G->in_src[e]]) {
+                    queued[G->in_src[e]] = 1;
+                    neighbours[found++] = G->in_src[e];
+                }
+            }
+            qsort(neighbours, found, sizeof(int), compare_degree_ascending);
+            memcpy(order + length, neighbours, sizeof(int) * found);
+            length += found;
+        }
+    }
+
+    for (int i = 0; i < nV/2; i++) {
+        int temp = order[i];
+        order[i] = order[nV-1-i];
+        order[nV-1-i] = temp;
+    }
+    free(by_degree);
+    free(neighbours);
+    free(queued);
+    return order;
+}
+
+
+
+//reordering functions//
+
+
+//return the new order of the vertices: order[i] is the current ID of the vertex that becomes vertex i
+int* vertex_order(graph G, enum vertex_order method) {
+    count_links(G);
+    degree_of = malloc(sizeof(int) * (G->nV > 0 ? G->nV : 1));
+    assert(degree_of);
+    for (int v = 0; v < G->nV; v++) degree_of[v] = G->links[v].links_in + G->links[v].links_out;
+
+    int* order;
+    if (method == ORDER_RCM) {
+        order = rcm_order(G);
+    } else {
+        order = malloc(sizeof(int) * (G->nV > 0 ? G->nV : 1));
+        assert(order);
+        for (int v = 0; v < G->nV; v++) order[v] = v;
+        if (method == ORDER_DEGREE) qsort(order, G->nV, sizeof(int), compare_degree);
+    }
+
+    free(degree_of);
+    degree_of = NULL;
+    return order;
+}
+
+//renumber the vertices of a compressed graph in place so that vertex order[i] becomes vertex i
+void reorder_graph(graph G, int* order, double* ranks) {
+    count_links(G);
+    int nV = G->nV;
+    int* position = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    struct info* old_links = malloc(sizeof(struct info) * (nV > 0 ? nV : 1));
+    char** old_map = malloc(sizeof(char*) * (nV > 0 ? nV : 1));
+    assert(position && old_links && old_map);
+    for (int v = 0; v < nV; v++) position[order[v]] = v;
+
+    // Per-vertex data moves with the vertex
+    memcpy(old_links, G->links, sizeof(struct info) * nV);
+    memcpy(old_map, G->map, sizeof(char*) * nV);
+    for (int v = 0; v < nV; v++) {
+        G->links[v] = old_links[order[v]];
+        G->map[v] = old_map[order[v]];
+    }
+    for (int id = 0; id < G->names->size; id++) G->vertex_of[id] = position[G->vertex_of[id]];
+    if (ranks != NULL) {
+        double* old_ranks = malloc(sizeof(double) * (nV > 0 ? nV : 1));
+        assert(old_ranks);
+        memcpy(old_ranks, ranks, sizeof(double) * nV);
+        for (int v = 0; v < nV; v++) ranks[v] = old_ranks[order[v]];
+        free(old_ranks);
+    }
+
+    if (G->out_dest != NULL) {
+        permute_edges(G, order, position);
+    } else {
+        G->out_start[0] = G->in_start[0] = 0;
+        for (int v = 0; v < nV; v++) {
+            G->out_start[v+1] = G->out_start[v] + G->links[v].links_out;
+            G->in_start[v+1] = G->in_start[v] + G->links[v].links_in;
+        }
+    }
+
+    free(position);
+    free(old_links);
+    free(old_map);
+}
+
+//move ranks indexed by the IDs of reorder_graph(G, order) back to the original IDs, leaving G as it is
+void restore_ranks(graph G, int* order, double* ranks) {
+    double* copy = malloc(sizeof(double) * (G->nV > 0 ? G->nV : 1));
+    assert(copy);
+    memcpy(copy, ranks, sizeof(double) * G->nV);
+    for (int v = 0; v < G->nV; v++) ranks[order[v]] = copy[v];
+    free(copy);
+}
+
+//undo reorder_graph(G, order), also moving ranks (indexed by the reordered IDs) back to the original IDs
+void restore_order(graph G, int* order, double* ranks) {
+    int nV = G->nV;
+    int* inverse = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    assert(inverse);
+    for (int v = 0; v < nV; v++) inverse[order[v]] = v;
+    reorder_graph(G, inverse, ranks);
+    free(inverse);
+}
@@ -0,0 +1,27 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "graph.h"
+
+//ways to renumber the vertices of a graph so that the ranks read together sit together in memory
+enum vertex_order {
+    ORDER_NONE,             //keep the order of collection.txt
+    ORDER_DEGREE,           //most linked vertices first
+    ORDER_RCM               //reverse Cuthill-McKee: breadth first over links in either direction, reversed
+};
+
+//return the new order of the vertices: order[i] is the current ID of the vertex that becomes vertex i
+int* vertex_order(graph G, enum vertex_order method);
+
+//renumber the vertices of a compressed graph in place so that vertex order[i] becomes vertex i
+//names, link counts, both edge layouts and their weights all move with the vertices, as do ranks if not NULL
+//a graph without weights, or whose edges were dropped (see drop_edges), is renumbered with what it has
+void reorder_graph(graph G, int* order, double* ranks);
+
+//move ranks indexed by the IDs of reorder_graph(G, order) back to the original IDs, leaving G as it is
+void restore_ranks(graph G, int* order, double* ranks);
+
+//undo reorder_graph(G, order), also moving ranks (indexed by the reordered IDs) back to the original IDs
+void restore_order(graph G, int* order, double* ranks);
+
+#endif
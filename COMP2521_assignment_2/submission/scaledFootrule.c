@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include "dist.h"
+#include "instrument.h"
 
 #define LARGE_VALUE 1000000
 #define TRUE_ '1'
@@ -74,9 +75,12 @@ int main(int argc, char** argv) {
     	fprintf(stderr,"Usage: %s [rank1] [rank2] ... [rankN]\n",argv[0]);
     	abort();
     }
+	start_instrument(argv[0]);
 	// generate the data struct containing the number of elements, the names of the elements
 	// and the cost of putting each element in each position
+	struct stage_timer timer = start_stage("read");
 	data d = gen_tree(argc, argv);
+	stop_stage(timer);
 	
 	//if there were no elements to rank, exit
 	if (d->no_elements == 0) {
@@ -91,10 +95,12 @@ int main(int argc, char** argv) {
 	for (int i = 0; i < size; arr[i++].next = -1);
     
     // call the recursive function to calculate the minimum cost
+	timer = start_stage("solve");
 	rec_rank(d, 0, 0, 0);
+	stop_stage(timer);
 	
 	
-	printf("cost: %lf\n", arr[0]);
+	printf("cost: %lf\n", arr[0].cost);
 	
 	// retrieve information about the minimum way to arrange the elements from the cache tree
 	/*
@@ -111,7 +117,6 @@ int main(int argc, char** argv) {
 	
 	
 	// free all relevant memory
-	free(used);
 	free(arr);
 	drop(d);
 }
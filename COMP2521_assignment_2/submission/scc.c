@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include "graph.h"
+#include "kernel.h"
+#include "threads.h"
+#include "scc.h"
+
+//Pagerank by strongly connected components
+//rank only flows along edges, so once every component that links into a component has converged,
+//that component can be solved on its own with their contributions held fixed; acyclic parts of the
+//graph are then solved exactly, and a slow component no longer keeps the rest of the graph iterating
+//each component counts the edges still to arrive from unsolved components, and becomes ready when
+//that reaches zero; threads take ready components from a shared queue, so independent branches of
+//the component graph are solved at the same time
+
+
+
+//the shared state of one solve
+struct scc_job {
+    graph G;
+    components C;
+    double* scaled;
+    double teleport;
+    double min_diff;
+    int max_iterations;
+    double* rank;
+    double* next;               //scratch for the Jacobi iteration inside a component
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int* waiting;               //the edges from unsolved components into every component
+    int* ready;                 //components whose upstream components are all solved
+    int n_ready;
+    int solved;
+    long updates;
+};
+
+
+
+//helper functions//
+
+
+//find the strongly connected components of a compressed graph (iterative Tarjan)
+components find_components(graph G) {
+    count_links(G);
+    int nV = G->nV;
+    components C = malloc(sizeof(struct _components));
+    assert(C);
+    C->count = 0;
+    C->of = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    C->start = malloc(sizeof(int) * (nV + 1));
+    C->members = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    int* index = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    int* low = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    int* stack = malloc(sizeof(int) * (nV > 0 ? nV : 1));
+    char* on_stack = calloc(nV > 0 ? nV : 1, sizeof(char));
+    int* call = malloc(sizeof(int) * (nV > 0 ? nV : 1));        //the depth first search path
+    int* edge = malloc(sizeof(int) * (nV > 0 ? nV : 1));        //the next out-edge of each vertex on the path
+    assert(C->of && C->start && C->members && index && low && stack && on_stack && call && edge);
+    for (int v = 0; v < nV; v++) index[v] = -1;
+
+    int counter = 0;
+    int top = 0;
+    int members = 0;
+    for (int root = 0; root < nV; root++) {
+        if (index[root] != -1) continue;
+        int depth = 0;
+        call[depth] = root;
+        edge[root] = G->out_start[root];
+        index[root] = low[root] = counter++;
+        stack[top++] = root;
+        on_stack[root] = 1;
+        while (depth >= 0) {
+            int v = call[depth];
+            if (edge[v] < G->out_start[v+1]) {
+                // Visit the next out-edge
+                int w = G->out_dest[edge[v]++];
+                if (index[w] == -1) {
+                    index[w] = low[w] = counter++;
+                    stack[top++] = w;
+                    on_stack[w] = 1;
+                    edge[w] = G->out_start[w];
+                    call[++depth] = w;
+                } else if (on_stack[w] && index[w] < low[v]) {
+                    low[v] = index[w];
+                }
+                continue;
+            }
+
+            // All edges of v are done: pop its component if it is the root of one
+            if (low[v] == index[v]) {
+                C->start[C->count] = members;
+                int w;
+                do {
+                    w = stack[--top];
+                    on_stack[w] = 0;
+                    C->of[w] = C->count;
+                    C->members[members++] = w;
+                } while (w != v);
+                C->count++;
+            }
+            depth--;
+            if (depth >= 0 && low[v] < low[call[depth]]) low[call[depth]] = low[v];
+        }
+    }
+    C->start[C->count] = members;
+
+    free(index);
+    free(low);
+    free(stack);
+    free(on_stack);
+    free(call);
+    free(edge);
+    return C;
+}
+
+//free all memory associated with the components
+void drop_components(components C) {
+    free(C->of);
+    free(C->start);
+    free(C->members);
+    free(C);
+}
+
+//solve one component with the ranks of its upstream components fixed, returning the vertex updates made
+static long solve_component(struct scc_job* job, int c) {
+    graph G = job->G;
+    int* of = job->C->of;
+    int* members = job->C->members + job->C->start[c];
+    int size = job->C->start[c+1] - job->C->start[c];
+    double* rank = job->rank;
+    double* next = job->next;
+
+    // The part of every rank that comes from outside the component is fixed, keep it in next
+    int internal = 0;
+    for (int i = 0; i < size; i++) {
+        int v = members[i];
+        double value = job->teleport;
+        for (int e = G->in_start[v]; e < G->in_start[v+1]; e++) {
+            if (of[G->in_src[e]] != c) value += job->scaled[e]*rank[G->in_src[e]];
+            else internal = 1;
+        }
+        next[v] = value;
+    }
+    //a vertex on its own has no internal edges (there are no loops), so it is already exact
+    if (!internal) {
+        for (int i = 0; i < size; i++) rank[members[i]] = next[members[i]];
+        return size;
+    }
+
+    double* fixed = malloc(sizeof(double) * size);
+    double* old = malloc(sizeof(double) * size);
+    assert(fixed && old);
+    for (int i = 0; i < size; i++) {
+        fixed[i] = next[members[i]];
+        old[i] = 1.0/G->nV;
+        rank[members[i]] = old[i];
+    }
+
+    double tolerance = job->min_diff * size / G->nV;
+    long updates = 0;
+    for (int count = 0; count < job->max_iterations; count++) {
+        double diff = 0;
+        for (int i = 0; i < size; i++) {
+            int v = members[i];
+            double value = fixed[i];
+            for (int e = G->in_start[v]; e < G->in_start[v+1]; e++) {
+                if (of[G->in_src[e]] == c) value += job->scaled[e]*rank[G->in_src[e]];
+            }
+            next[v] = value;
+            diff += fabs(old[i]-value);
+        }
+        for (int i = 0; i < size; i++) rank[members[i]] = old[i] = next[members[i]];
+        updates += size;
+        if (diff < tolerance) break;
+    }
+
+    free(fixed);
+    free(old);
+    return updates;
+}
+
+//take ready components and solve them until every component is solved
+static void scc_worker(int id, void* arg) {
+    (void)id;
+    struct scc_job* job = arg;
+    graph G = job->G;
+    components C = job->C;
+    pthread_mutex_lock(&job->lock);
+    while (job->solved < C->count) {
+        if (job->n_ready == 0) {
+            pthread_cond_wait(&job->changed, &job->lock);
+            continue;
+        }
+        int c = job->ready[--job->n_ready];
+        pthread_mutex_unlock(&job->lock);
+        long updates = solve_component(job, c);
+
+        // Release the components downstream of c
+        pthread_mutex_lock(&job->lock);
+        job->updates += updates;
+        job->solved++;
+        for (int i = C->start[c]; i < C->start[c+1]; i++) {
+            int v = C->members[i];
+            for (int e = G->out_start[v]; e < G->out_start[v+1]; e++) {
+                int d = C->of[G->out_dest[e]];
+                if (d != c && --job->waiting[d] == 0) job->ready[job->n_ready++] = d;
+            }
+        }
+        pthread_cond_broadcast(&job->changed);
+    }
+    pthread_mutex_unlock(&job->lock);
+}
+
+
+
+//calculate the Pagerank of every vertex one strongly connected component at a time
+double* scc_weights(graph G, double damping_factor, double min_diff, int max_iterations, int threads,
+                    int* count, long* updates) {
+    int size = G->nV;
+    struct scc_job job;
+    job.G = G;
+    job.C = find_components(G);
+    job.scaled = scale_weights(G, damping_factor);
+    job.teleport = (1-damping_factor)/size;
+    job.min_diff = min_diff;
+    job.max_iterations = max_iterations;
+    job.rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    job.next = malloc(sizeof(double) * (size > 0 ? size : 1));
+    job.waiting = calloc(job.C->count > 0 ? job.C->count : 1, sizeof(int));
+    job.ready = malloc(sizeof(int) * (job.C->count > 0 ? job.C->count : 1));
+    assert(job.rank && job.next && job.waiting && job.ready);
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.changed, NULL);
+    job.n_ready = 0;
+    job.solved = 0;
+    job.updates = 0;
+
+    // Count the edges arriving at every component from other components
+    for (int v = 0; v < size; v++) {
+        for (int e = G->out_start[v]; e < G->out_start[v+1]; e++) {
+            int d = job.C->of[G->out_dest[e]];
+            if (d != job.C->of[v]) job.waiting[d]++;
+        }
+    }
+    for (int c = 0; c < job.C->count; c++) {
+        if (job.waiting[c] == 0) job.ready[job.n_ready++] = c;
+    }
+
+    run_threads(threads, scc_worker, &job);
+
+    *count = job.C->count;
+    *updates = job.updates;
+    pthread_mutex_destroy(&job.lock);
+    pthread_cond_destroy(&job.changed);
+    drop_components(job.C);
+    free(job.scaled);
+    free(job.next);
+    free(job.waiting);
+    free(job.ready);
+    return job.rank;
+}
@@ -0,0 +1,31 @@
+#ifndef SCC_H
+#define SCC_H
+
+#include "graph.h"
+
+//the strongly connected components of a graph, numbered so every edge between two components goes
+//from a higher numbered component to a lower numbered one
+typedef struct _components {
+    int count;
+    int* of;                    //the component of every vertex
+    int* start;                 //the vertices of component c are members[start[c]] .. members[start[c+1]-1]
+    int* members;
+} *components;
+
+//find the strongly connected components of a compressed graph (iterative Tarjan)
+components find_components(graph G);
+
+//free all memory associated with the components
+void drop_components(components C);
+
+//calculate the Pagerank of every vertex one strongly connected component at a time, upstream
+//components first, so each component iterates only until it has converged itself with the ranks of
+//the components feeding it already fixed
+//a component of n vertices stops once its L1 diff is below min_diff*n/nV, so the diffs add up to at
+//most min_diff; single vertices are solved exactly in one step
+//components whose upstream components are done are solved in parallel on 'threads' threads
+//stores the number of components in *count and the number of vertex updates in *updates
+double* scc_weights(graph G, double damping_factor, double min_diff, int max_iterations, int threads,
+                    int* count, long* updates);
+
+#endif
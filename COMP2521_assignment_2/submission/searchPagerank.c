@@ -3,7 +3,9 @@
 #include <stdlib.h>
 #include <assert.h>
 #include "strdup.h"
+#include "intern.h"
 #include "BST.h"
+#include "instrument.h"
 
 #define MAX_WORD_SIZE 50
 
@@ -11,6 +13,7 @@
 //Then for each word that is being searched for, marking every url that contains that word to being 'present'
 //This is done by regenerating a tree identical to the one in invertedIndex and using the tree to return
 //linked lists of urls that contain certain words
+//urls are interned so that marking a url as 'present' is a hash lookup rather than a scan of the rank list
 
 typedef struct _rank_node {
     int present;
@@ -24,11 +27,14 @@ rank_node create_rank_node(char* url);
 //read ranks from pagerankList.txt into a linked list in order
 rank_node read_ranks(char* file);
 
+//intern every ranked url and return an array giving the rank node of each interned ID
+rank_node* index_ranks(rank_node head, intern_table names);
+
 //generate an inverted index tree from the inverted index file
 Tree generate_tree(char* file);
 
 //mark the specified url in the rank linked list as containing a search term
-void enable(rank_node head, char* url);
+void enable(rank_node* by_id, intern_table names, char* url);
 
 //drop the linked list of ranked urls
 void drop_rank_list(rank_node head);
@@ -39,16 +45,26 @@ int main(int argc, char** argv) {
     	fprintf(stderr,"Usage: %s [term1] [term2] ... [termN]\n",argv[0]);
     	abort();
     }
+    start_instrument(argv[0]);
+    struct stage_timer timer = start_stage("read ranks");
     rank_node rank_head = read_ranks("pagerankList.txt");
+    intern_table names = create_intern_table(0);
+    rank_node* by_id = index_ranks(rank_head, names);
+    stop_stage(timer);
+    timer = start_stage("read index");
     Tree t = generate_tree("invertedIndex.txt");
+    stop_stage(timer);
+    timer = start_stage("search");
     for (int i = 1; i < argc; i++) {		//loop through search terms
         char* word = argv[i];
         url_node curr = return_list(t,word);
         while (curr != NULL) {
-            enable(rank_head,curr->url);
+            enable(by_id,names,curr->url);
             curr = curr->next;
         }
     }
+    stop_stage(timer);
+    timer = start_stage("print");
     int to_print = 30;
    	//initialize num to be the number of search terms
     int num = argc - 1;
@@ -63,13 +79,16 @@ int main(int argc, char** argv) {
 		}
 		num--;
 	}
+    stop_stage(timer);
     drop_rank_list(rank_head);
+    drop_intern_table(names);
+    free(by_id);
     drop_tree(t);
 }
 
 //helper function to create rank nodes and return a pointer to them
 rank_node create_rank_node(char* url) {
-    rank_node new_node = malloc(sizeof(struct _rank_node));
+    rank_node new_node = counted_malloc(sizeof(struct _rank_node));
     assert(new_node);
     new_node->present = 0;
     new_node->next = NULL;
@@ -82,7 +101,7 @@ rank_node read_ranks(char* file) {
     rank_node head = NULL;
     rank_node last = NULL;
     char url[MAX_WORD_SIZE];
-    FILE* input = fopen(file,"r");
+    FILE* input = counted_fopen(file,"r");
     assert(input);
     int insert = 0;
     while (fscanf(input, "%s", url) == 1) {
@@ -99,16 +118,31 @@ rank_node read_ranks(char* file) {
             insert--;
         }
     }
-    fclose(input);
+    counted_fclose(input);
     return head;
 }
 
+//intern every ranked url and return an array giving the rank node of each interned ID
+rank_node* index_ranks(rank_node head, intern_table names) {
+    int size = 0;
+    for (rank_node curr = head; curr != NULL; curr = curr->next) size++;
+    rank_node* by_id = counted_malloc(sizeof(rank_node) * (size > 0 ? size : 1));
+    assert(by_id);
+    for (rank_node curr = head; curr != NULL; curr = curr->next) {
+        int interned = names->size;
+        int id = intern(names, curr->url);
+        //a url listed twice keeps its first (highest ranked) node
+        if (names->size > interned) by_id[id] = curr;
+    }
+    return by_id;
+}
+
 //generate an inverted index tree from the inverted index file
 Tree generate_tree(char* file) {
     Tree t = create_tree();
     char item[MAX_WORD_SIZE];
     char word[MAX_WORD_SIZE];
-    FILE* input = fopen(file,"r");
+    FILE* input = counted_fopen(file,"r");
     assert(input);
     int new_word = 1;
     while (fscanf(input,"%s", item) == 1) {
@@ -126,19 +160,14 @@ Tree generate_tree(char* file) {
     	if (c == '\n') new_word = 1;
     	else ungetc(c, input);
     }
-    fclose(input);
+    counted_fclose(input);
     return t;
 }
 
 //mark the specified url in the rank linked list as containing a search term
-void enable(rank_node curr, char* url) {
-    while (curr != NULL) {
-        if(strcmp(url,curr->url) == 0) {
-            curr->present++;
-            return;
-        }
-        curr = curr->next;
-    }
+void enable(rank_node* by_id, intern_table names, char* url) {
+    int id = intern_lookup(names, url);
+    if (id != -1) by_id[id]->present++;
 }
 
 //drop the linked list of ranked urls
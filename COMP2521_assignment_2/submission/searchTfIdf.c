@@ -4,6 +4,7 @@
 #include <assert.h>
 #include "RBTree.h"
 #include "read_data.h"
+#include "instrument.h"
 
 // Calculate the TfIdf for each URL that contains a query term as a command line argument
 void searchTfIdf(int argc, char** argv)
@@ -17,18 +18,23 @@ void searchTfIdf(int argc, char** argv)
 
     // To calculate the inverse document frequency, it is necessary to determine the total
     // number of URLs available on the web which would be provided in collection.txt
+    struct stage_timer timer = start_stage("read collection");
     Rep all_urls = read_collection();
     int total_documents = all_urls->size;
     free_rep(all_urls);
+    stop_stage(timer);
     if (total_documents == 0) return;
 
     // Collect all of the search terms into a linked list with each node containing a separate
-    // linked list to all the URLs in which the term appears.
+    // array of all the URLs in which the term appears.
+    timer = start_stage("search index");
     Content search_terms = search_index(argc, argv);
+    stop_stage(timer);
 
     // Create a RBTree with the key of a node as the URL of a page.
     // As the tree is formed, calculate the TfIdf value for a search term on a given page
     // and sum it to the existing tfidf value if the node exists.
+    timer = start_stage("score");
     Tree_Rep url_tree = new_RBTree(); 
     Content curr = search_terms;
 
@@ -44,18 +50,19 @@ void searchTfIdf(int argc, char** argv)
         
         // Separate iteration that searches through URLs that contain a search term
         // Will calculate the term frequency (tf) for each URL 
-        Data url = curr->url_list;
-        for (; url != NULL; url = url->next)
+        for (int u = 0; u < curr->total; u++)
         {
-            Rep words = read_data(url->info);
-            int frequency = count_instances(words->data_list, curr->str);
-            double tf = ((double) frequency)/words->size;
+            char *url = curr->urls[u];
+            Document doc = read_document(url);
+            int frequency = term_frequency(doc, curr->str);
+            double tf = ((double) frequency)/doc->n_words;
             double tfidf = tf * idf;
-            RBTree_insert_url(url_tree, tfidf, url->info);
-            free_rep(words);
+            RBTree_insert_url(url_tree, tfidf, url);
+            free_document(doc);
         }
     }
     free_search(search_terms); 
+    stop_stage(timer);
 
     // The TfIdf values have been calculated for all of the URLs that contain a query 
     // term at this point. It is now necessary to output the top 30 URLs in descending
@@ -63,6 +70,7 @@ void searchTfIdf(int argc, char** argv)
     // will be sorted into groups based on the number of terms common with the command line
     // arguments and then sorted by TfIdf values.
 
+    timer = start_stage("print");
     Tree_Rep group_tree = new_RBTree();
     transfer_nodes(url_tree->root, group_tree);
     free_RBTree(url_tree);
@@ -79,10 +87,12 @@ void searchTfIdf(int argc, char** argv)
     descending_print_group(group_tree->root, limit, count);
     free(count);
     free_RBTree_Group(group_tree);
+    stop_stage(timer);
 }
 
 int main(int argc, char** argv)
 {
+    start_instrument(argv[0]);
     searchTfIdf(argc, argv);
     return 0;
 }
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include "graph.h"
+#include "single.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_AVX2_KERNEL 1
+#endif
+
+//Single precision Pagerank
+//the pull update reads a weight and a source rank for every edge, so storing both as float halves
+//the bytes moved per edge and lets twice as much of the rank vector stay in cache
+//each rank is summed in float, but the L1 diff that decides when to stop is summed in double: it
+//adds up nV small terms and would otherwise lose the last iterations' changes
+//a float holds about 7 significant digits, so the ranks agree with the double run to around 1e-7
+//relative, which is the precision pagerankList.txt is written with; ranks closer than that may swap
+
+
+
+//portable version of the single precision pull update
+double pull_float_scalar(graph G, float* scaled, float teleport, float* old_rank, float* new_rank, int first, int last) {
+    double diff = 0;
+    for (int vert = first; vert < last; vert++) {
+        float rank = teleport;
+        for (int e = G->in_start[vert]; e < G->in_start[vert+1]; e++) {
+            rank += scaled[e]*old_rank[G->in_src[e]];
+        }
+        new_rank[vert] = rank;
+        diff += fabs((double)old_rank[vert]-rank);
+    }
+    return diff;
+}
+
+#ifdef HAVE_AVX2_KERNEL
+
+//AVX2 version of the single precision pull update, eight in-edges at a time
+__attribute__((target("avx2,fma")))
+double pull_float_avx2(graph G, float* scaled, float teleport, float* old_rank, float* new_rank, int first, int last) {
+    double diff = 0;
+    for (int vert = first; vert < last; vert++) {
+        int e = G->in_start[vert];
+        int end = G->in_start[vert+1];
+
+        // Gather the ranks of eight sources at once and multiply them by their weights
+        __m256 sum = _mm256_setzero_ps();
+        for (; e + 8 <= end; e += 8) {
+            __m256i sources = _mm256_loadu_si256((const __m256i*)(G->in_src + e));
+            __m256 ranks = _mm256_i32gather_ps(old_rank, sources, 4);
+            sum = _mm256_fmadd_ps(_mm256_loadu_ps(scaled + e), ranks, sum);
+        }
+        __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+        half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+        half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+        float rank = teleport + _mm_cvtss_f32(half);
+
+        // Finish the edges that did not fill a vector
+        for (; e < end; e++) rank += scaled[e]*old_rank[G->in_src[e]];
+        new_rank[vert] = rank;
+        diff += fabs((double)old_rank[vert]-rank);
+    }
+    return diff;
+}
+
+//return the fastest single precision pull update the running CPU supports
+pull_float_kernel select_pull_float_kernel(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return pull_float_avx2;
+    return pull_float_scalar;
+}
+
+#else
+
+//AVX2 is not available on this platform, fall back to the portable version
+double pull_float_avx2(graph G, float* scaled, float teleport, float* old_rank, float* new_rank, int first, int last) {
+    return pull_float_scalar(G, scaled, teleport, old_rank, new_rank, first, last);
+}
+
+//return the fastest single precision pull update the running CPU supports
+pull_float_kernel select_pull_float_kernel(void) {
+    return pull_float_scalar;
+}
+
+#endif
+
+//calculate the Pagerank of every vertex with the weights and ranks stored as float
+double* float_weights(graph G, double damping_factor, double min_diff, int max_iterations, int* iterations) {
+    int size = G->nV;
+    float* scaled = malloc(sizeof(float) * (G->nE > 0 ? G->nE : 1));
+    float* old_rank = malloc(sizeof(float) * (size > 0 ? size : 1));
+    float* new_rank = malloc(sizeof(float) * (size > 0 ? size : 1));
+    assert(scaled && old_rank && new_rank);
+    for (int e = 0; e < G->nE; e++) scaled[e] = damping_factor*G->in_weight[e];
+    for (int i = 0; i < size; i++) old_rank[i] = new_rank[i] = 1.0f/size;
+
+    pull_float_kernel pull = select_pull_float_kernel();
+    int count = 0;
+    while (count < max_iterations) {
+        double diff = pull(G, scaled, (1-damping_factor)/size, old_rank, new_rank, 0, size);
+        count++;
+        if (diff < min_diff || count == max_iterations) break;
+        float* temp = old_rank;
+        old_rank = new_rank;
+        new_rank = temp;
+    }
+
+    double* rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    assert(rank);
+    for (int i = 0; i < size; i++) rank[i] = new_rank[i];
+    *iterations = count;
+    free(scaled);
+    free(old_rank);
+    free(new_rank);
+    return rank;
+}
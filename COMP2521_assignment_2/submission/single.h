@@ -0,0 +1,24 @@
+#ifndef SINGLE_H
+#define SINGLE_H
+
+#include "graph.h"
+
+//one pull update of the vertices first .. last-1 with single precision weights and ranks
+//the L1 diff it returns is accumulated in double precision
+typedef double (*pull_float_kernel)(graph G, float* scaled, float teleport, float* old_rank, float* new_rank, int first, int last);
+
+//portable version of the single precision pull update
+double pull_float_scalar(graph G, float* scaled, float teleport, float* old_rank, float* new_rank, int first, int last);
+
+//AVX2 version of the single precision pull update, eight in-edges at a time, only valid where the CPU
+//supports AVX2 and FMA
+double pull_float_avx2(graph G, float* scaled, float teleport, float* old_rank, float* new_rank, int first, int last);
+
+//return the fastest single precision pull update the running CPU supports
+pull_float_kernel select_pull_float_kernel(void);
+
+//calculate the Pagerank of every vertex with the weights and ranks stored as float, halving the
+//memory read per edge; iterates and stops like generate_weights and returns the ranks as double
+double* float_weights(graph G, double damping_factor, double min_diff, int max_iterations, int* iterations);
+
+#endif
@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "graph.h"
+#include "snapshot.h"
+#include "sources.h"
+
+//Graph snapshots
+//a snapshot holds a compressed, weighted graph exactly as it is laid out in memory, so loading one is
+//a single mmap with no parsing: the row/column arrays, weights and link counts of the graph point
+//straight into the mapping, only the url map and intern table are rebuilt
+
+//byte offset of every section of a snapshot
+struct layout {
+    long name_offset;
+    long links;
+    long out_start;
+    long out_dest;
+    long in_start;
+    long in_src;
+    long out_weight;
+    long in_weight;
+    long stamps;
+    long names;
+    long total;
+};
+
+
+
+//helper functions//
+
+
+//round up to the next multiple of 8
+static long align8(long offset) {
+    return (offset + 7) & ~7L;
+}
+
+//work out where every section of a snapshot starts
+static struct layout snapshot_layout(int nV, int nE, long long names_size) {
+    struct layout l;
+    l.name_offset = align8(sizeof(struct snapshot_header));
+    l.links = align8(l.name_offset + sizeof(int) * (long)nV);
+    l.out_start = align8(l.links + sizeof(struct info) * (long)nV);
+    l.out_dest = align8(l.out_start + sizeof(int) * ((long)nV + 1));
+    l.in_start = align8(l.out_dest + sizeof(int) * (long)nE);
+    l.in_src = align8(l.in_start + sizeof(int) * ((long)nV + 1));
+    l.out_weight = align8(l.in_src + sizeof(int) * (long)nE);
+    l.in_weight = align8(l.out_weight + sizeof(double) * (long)nE);
+    l.stamps = align8(l.in_weight + sizeof(double) * (long)nE);
+    l.names = align8(l.stamps + sizeof(struct source_stamp) * ((long)nV + 1));
+    l.total = l.names + names_size;
+    return l;
+}
+
+//write 'size' bytes at the given offset of the file, padding with zeros up to it
+static void write_section(FILE* output, long offset, void* data, long size) {
+    while (ftell(output) < offset) fputc(0, output);
+    if (size > 0) fwrite(data, 1, size, output);
+}
+
+
+
+//write a compressed, weighted graph to a snapshot file
+void write_graph_snapshot(graph G, char* file) {
+    assert(G->out_start != NULL);
+    int* name_offset = malloc(sizeof(int) * (G->nV > 0 ? G->nV : 1));
+    assert(name_offset);
+    long long names_size = 0;
+    for (int i = 0; i < G->nV; i++) {
+        name_offset[i] = names_size;
+        names_size += strlen(G->map[i]) + 1;
+    }
+
+    struct snapshot_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.nV = G->nV;
+    header.nE = G->nE;
+    header.names_size = names_size;
+    struct layout l = snapshot_layout(G->nV, G->nE, names_size);
+    assert(G->stamps);
+
+    FILE* output = fopen(file, "wb");
+    assert(output);
+    write_section(output, 0, &header, sizeof(header));
+    write_section(output, l.name_offset, name_offset, sizeof(int) * (long)G->nV);
+    write_section(output, l.links, G->links, sizeof(struct info) * (long)G->nV);
+    write_section(output, l.out_start, G->out_start, sizeof(int) * ((long)G->nV + 1));
+    write_section(output, l.out_dest, G->out_dest, sizeof(int) * (long)G->nE);
+    write_section(output, l.in_start, G->in_start, sizeof(int) * ((long)G->nV + 1));
+    write_section(output, l.in_src, G->in_src, sizeof(int) * (long)G->nE);
+    write_section(output, l.out_weight, G->out_weight, sizeof(double) * (long)G->nE);
+    write_section(output, l.in_weight, G->in_weight, sizeof(double) * (long)G->nE);
+    write_section(output, l.stamps, G->stamps, sizeof(struct source_stamp) * ((long)G->nV + 1));
+    write_section(output, l.names, NULL, 0);
+    for (int i = 0; i < G->nV; i++) fwrite(G->map[i], 1, strlen(G->map[i]) + 1, output);
+    fclose(output);
+    free(name_offset);
+}
+
+//map a snapshot file into memory and return it as a graph whose arrays point into the mapping
+graph load_graph_snapshot(char* file, int check_sources) {
+    int fd = open(file, O_RDONLY);
+    if (fd == -1) return NULL;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (long)sizeof(struct snapshot_header)) {
+        close(fd);
+        return NULL;
+    }
+
+    // A private writable mapping costs nothing unless a page is written, and then only that page is copied
+    char* base = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+
+    struct snapshot_header* header = (struct snapshot_header*)base;
+    struct layout l = snapshot_layout(header->nV, header->nE, header->names_size);
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 || l.total != (long)info.st_size ||
+        (check_sources && !sources_unchanged(base + l.names, header->nV, (struct source_stamp*)(base + l.stamps)))) {
+        munmap(base, info.st_size);
+        return NULL;
+    }
+
+    // Rebuild the url map and intern table, every other array is used in place
+    graph G = create_graph(header->nV);
+    int* name_offset = (int*)(base + l.name_offset);
+    for (int i = 0; i < G->nV; i++) add_vertex(G, base + l.names + name_offset[i]);
+
+    free(G->links);
+    free(G->pending);
+    free(G->edge_set);
+    G->pending = NULL;
+    G->edge_set = NULL;
+    G->n_pending = G->pending_cap = G->edge_set_cap = 0;
+    G->nE = header->nE;
+    G->links = (struct info*)(base + l.links);
+    G->out_start = (int*)(base + l.out_start);
+    G->out_dest = (int*)(base + l.out_dest);
+    G->in_start = (int*)(base + l.in_start);
+    G->in_src = (int*)(base + l.in_src);
+    G->out_weight = (double*)(base + l.out_weight);
+    G->in_weight = (double*)(base + l.in_weight);
+    G->snapshot = base;
+    G->snapshot_size = info.st_size;
+    return G;
+}
@@ -0,0 +1,33 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "graph.h"
+
+//first bytes of a graph snapshot file
+#define SNAPSHOT_MAGIC "PRGRAPH2"
+
+//header of a graph snapshot, followed by the sections below, each starting on an 8 byte boundary:
+//  int name_offset[nV]         offset of each url in the string table
+//  struct info links[nV]
+//  int out_start[nV+1], int out_dest[nE], int in_start[nV+1], int in_src[nE]
+//  double out_weight[nE], double in_weight[nE]
+//  struct source_stamp stamps[nV+1]   collection.txt, then the url file of each vertex
+//  char names[names_size]      the urls, each followed by '\0'
+//the file uses the byte order and type sizes of the machine that wrote it
+struct snapshot_header {
+    char magic[8];
+    int nV;
+    int nE;
+    long long names_size;
+};
+
+//write a compressed, weighted graph to a snapshot file, with the stamps the files were read under
+//G must have been read from the url files (see load_graph) and not yet reordered
+void write_graph_snapshot(graph G, char* file);
+
+//map a snapshot file into memory and return it as a graph whose arrays point into the mapping
+//returns NULL if the file is missing or is not a snapshot, or if 'check_sources' is set and
+//collection.txt or any url file has changed since the snapshot was written
+graph load_graph_snapshot(char* file, int check_sources);
+
+#endif
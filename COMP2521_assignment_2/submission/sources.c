@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/stat.h>
+#include "sources.h"
+
+//Source stamps
+//a snapshot or edge stream is only as fresh as every file it was built from, so it records the size
+//and nanosecond modification time of collection.txt and of each url file, and is rebuilt as soon as
+//one of them differs: editing a single url file between runs is enough
+//the stamps are taken by the reader from each open file before any of it is read (see read_data.h),
+//so a file edited while it was being read is newer than its stamp and counts as changed too
+//checking costs one stat per url, far less than parsing the files again
+
+
+
+//helper functions//
+
+
+//stamp one file, a missing file gets a size of -1 so it never matches a stamp of a real file
+static struct source_stamp stamp_file(char* file) {
+    struct source_stamp stamp = {-1, 0, 0};
+    struct stat info;
+    if (stat(file, &info) == 0) {
+        stamp.size = info.st_size;
+        stamp.seconds = info.st_mtim.tv_sec;
+        stamp.nanoseconds = info.st_mtim.tv_nsec;
+    }
+    return stamp;
+}
+
+//stamp the url file of a url, which is the url followed by .txt
+static struct source_stamp stamp_url(char* url) {
+    char* file = malloc(strlen(url) + 5);
+    assert(file);
+    strcpy(file, url);
+    strcat(file, ".txt");
+    struct source_stamp stamp = stamp_file(file);
+    free(file);
+    return stamp;
+}
+
+//compare two stamps field by field (the struct may hold padding)
+static int same_stamp(struct source_stamp a, struct source_stamp b) {
+    return a.size == b.size && a.seconds == b.seconds && a.nanoseconds == b.nanoseconds;
+}
+
+
+
+//interface functions//
+
+
+//return 1 if collection.txt and the url file of every listed url still match their stamps
+int sources_unchanged(char* names, int count, struct source_stamp* stamps) {
+    if (stamps[0].size < 0 || !same_stamp(stamp_file(COLLECTION_FILE), stamps[0])) return 0;
+    char* name = names;
+    for (int i = 0; i < count; i++) {
+        if (!same_stamp(stamp_url(name), stamps[i + 1])) return 0;
+        name += strlen(name) + 1;
+    }
+    return 1;
+}
@@ -0,0 +1,13 @@
+#ifndef SOURCES_H
+#define SOURCES_H
+
+#include "read_data.h"
+
+//the file listing the urls, read by read_collection
+#define COLLECTION_FILE "collection.txt"
+
+//return 1 if collection.txt and the url files of the 'count' urls in 'names' (each followed by '\0',
+//one after another) all still match their stamps, 0 if any of them was changed or removed
+int sources_unchanged(char* names, int count, struct source_stamp* stamps);
+
+#endif
@@ -0,0 +1,425 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "graph.h"
+#include "read_data.h"
+#include "stream.h"
+#include "sources.h"
+
+//Out of core Pagerank
+//the edges are preprocessed into a flat file in in-edge order, so one iteration is a single
+//sequential read of the file: each edge adds damping*weight*rank[src] to rank[dest], in the same
+//order as pull_scalar, and only the two rank vectors stay in memory
+//blocks are read with pread into a page aligned buffer, and the kernel is asked to start reading
+//the next block (POSIX_FADV_WILLNEED) before the current one is processed, so the disk stays busy
+//while the ranks are updated
+//the file is built without the graph ever being held in memory, so the graph only has to fit on disk:
+//the links are spilled in sorted runs and merged, an external sort by destination, then counted and
+//weighted in sequential passes over the merged edges
+
+//edges are spilled to disk in sorted runs of this many, which bounds the memory used to build a stream
+#define RUN_EDGES (4 << 20)
+
+//edges read from each run at a time while merging, and from the merged edges in the later passes
+#define MERGE_EDGES (64 << 10)
+
+//an edge while the stream is built, as dest << 32 | src so that sorting the keys sorts the edges by
+//destination, then by source
+typedef unsigned long long edge_key;
+
+//a sorted run of edge keys in the spill file, read a buffer at a time while the runs are merged
+struct run {
+    long long next;             //index in the spill file of the next key to read
+    long long end;
+    edge_key* buffer;
+    int size;
+    int pos;
+};
+
+
+
+//helper functions//
+
+
+//byte offset of the links and names sections
+static long long links_offset(int nE) {
+    return STREAM_BLOCK + sizeof(struct stream_edge) * (long long)nE;
+}
+
+//byte offset of the source stamps, which end the file
+static long long stamps_offset(int nV, int nE, long long names_size) {
+    return links_offset(nE) + sizeof(struct info) * (long long)nV + names_size;
+}
+
+//read exactly 'size' bytes at 'offset', aborting on a short read
+static void read_fully(int fd, void* buffer, long size, long long offset) {
+    char* cursor = buffer;
+    while (size > 0) {
+        ssize_t got = pread(fd, cursor, size, offset);
+        if (got <= 0) {
+            fprintf(stderr,"Edge stream file is truncated\n");
+            abort();
+        }
+        cursor += got;
+        size -= got;
+        offset += got;
+    }
+}
+
+//return 1 if the sources of an edge stream file are unchanged since it was written
+static int stream_sources_unchanged(int fd, struct stream_header header) {
+    char* names = malloc(header.names_size > 0 ? header.names_size : 1);
+    struct source_stamp* stamps = malloc(sizeof(struct source_stamp) * ((long)header.nV + 1));
+    assert(names && stamps);
+    long long offset = stamps_offset(header.nV, header.nE, header.names_size);
+    read_fully(fd, names, header.names_size, offset - header.names_size);
+    read_fully(fd, stamps, sizeof(struct source_stamp) * ((long)header.nV + 1), offset);
+    int unchanged = sources_unchanged(names, header.nV, stamps);
+    free(names);
+    free(stamps);
+    return unchanged;
+}
+
+//write exactly 'size' bytes at 'offset', aborting if the disk is full
+static void write_fully(int fd, void* buffer, long size, long long offset) {
+    char* cursor = buffer;
+    while (size > 0) {
+        ssize_t put = pwrite(fd, cursor, size, offset);
+        if (put <= 0) {
+            fprintf(stderr,"Unable to write the edge stream's temporary files\n");
+            abort();
+        }
+        cursor += put;
+        size -= put;
+        offset += put;
+    }
+}
+
+//open a temporary file named after the stream file, which is removed as soon as it is closed
+static int open_temporary(char* file, char* suffix) {
+    char* name = malloc(strlen(file) + strlen(suffix) + 1);
+    assert(name);
+    sprintf(name, "%s%s", file, suffix);
+    int fd = open(name, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd == -1) {
+        fprintf(stderr,"Unable to create %s\n",name);
+        abort();
+    }
+    unlink(name);
+    free(name);
+    return fd;
+}
+
+//order edge keys in ascending order
+static int compare_keys(const void* a, const void* b) {
+    edge_key x = *(const edge_key*)a;
+    edge_key y = *(const edge_key*)b;
+    return x < y ? -1 : x > y;
+}
+
+//sort 'count' keys, drop repeated edges and append them to the spill file as a new run
+static struct run spill_run(int fd, edge_key* keys, int count, long long offset) {
+    qsort(keys, count, sizeof(edge_key), compare_keys);
+    int unique = 0;
+    for (int i = 0; i < count; i++) {
+        if (unique == 0 || keys[i] != keys[unique-1]) keys[unique++] = keys[i];
+    }
+    write_fully(fd, keys, sizeof(edge_key) * (long)unique, sizeof(edge_key) * offset);
+    struct run r = {offset, offset + unique, NULL, 0, 0};
+    return r;
+}
+
+//spill the 'count' keys gathered so far as a run after the last one, growing the list of runs
+static void add_run(int spill, edge_key* keys, int count, struct run** runs, int* n_runs, int* runs_cap) {
+    if (*n_runs == *runs_cap) {
+        *runs_cap = *runs_cap > 0 ? *runs_cap * 2 : 16;
+        *runs = realloc(*runs, sizeof(struct run) * *runs_cap);
+        assert(*runs);
+    }
+    long long offset = *n_runs > 0 ? (*runs)[*n_runs - 1].end : 0;
+    (*runs)[*n_runs] = spill_run(spill, keys, count, offset);
+    ++*n_runs;
+}
+
+//read the next buffer of a run, returning 0 once the run is used up
+static int refill_run(int fd, struct run* r) {
+    long long left = r->end - r->next;
+    r->size = left < MERGE_EDGES ? left : MERGE_EDGES;
+    r->pos = 0;
+    if (r->size == 0) return 0;
+    read_fully(fd, r->buffer, sizeof(edge_key) * (long)r->size, sizeof(edge_key) * r->next);
+    r->next += r->size;
+    return 1;
+}
+
+//restore the heap of runs below 'pos', ordered by the next key of each run
+static void sift_runs(struct run* runs, int* heap, int size, int pos) {
+    while (1) {
+        int least = pos;
+        int left = 2*pos + 1;
+        int right = left + 1;
+        if (left < size && runs[heap[left]].buffer[runs[heap[left]].pos] < runs[heap[least]].buffer[runs[heap[least]].pos]) least = left;
+        if (right < size && runs[heap[right]].buffer[runs[heap[right]].pos] < runs[heap[least]].buffer[runs[heap[least]].pos]) least = right;
+        if (least == pos) return;
+        int temp = heap[pos];
+        heap[pos] = heap[least];
+        heap[least] = temp;
+        pos = least;
+    }
+}
+
+//merge the sorted runs of the spill file into 'sorted', dropping edges repeated across runs and
+//counting the links of every vertex; returns the number of edges written
+static long long merge_runs(graph G, int spill, struct run* runs, int n_runs, int sorted) {
+    int* heap = malloc(sizeof(int) * (n_runs > 0 ? n_runs : 1));
+    edge_key* output = malloc(sizeof(edge_key) * MERGE_EDGES);
+    assert(heap && output);
+    int size = 0;
+    for (int r = 0; r < n_runs; r++) {
+        runs[r].buffer = malloc(sizeof(edge_key) * MERGE_EDGES);
+        assert(runs[r].buffer);
+        if (refill_run(spill, &runs[r])) heap[size++] = r;
+    }
+    for (int i = size/2 - 1; i >= 0; i--) sift_runs(runs, heap, size, i);
+
+    long long written = 0;
+    int pending = 0;
+    edge_key last = 0;
+    while (size > 0) {
+        struct run* r = &runs[heap[0]];
+        edge_key key = r->buffer[r->pos++];
+        if (written + pending == 0 || key != last) {
+            last = key;
+            output[pending++] = key;
+            G->links[key >> 32].links_in++;
+            G->links[(int)(key & 0xffffffff)].links_out++;
+            if (pending == MERGE_EDGES) {
+                write_fully(sorted, output, sizeof(edge_key) * (long)pending, sizeof(edge_key) * written);
+                written += pending;
+                pending = 0;
+            }
+        }
+        if (r->pos == r->size && !refill_run(spill, r)) heap[0] = heap[--size];
+        sift_runs(runs, heap, size, 0);
+    }
+    write_fully(sorted, output, sizeof(edge_key) * (long)pending, sizeof(edge_key) * written);
+    written += pending;
+
+    for (int r = 0; r < n_runs; r++) free(runs[r].buffer);
+    free(heap);
+    free(output);
+    return written;
+}
+
+
+
+//build an edge stream file from the url files without building the graph in memory
+void build_edge_stream(char* file) {
+    // Only the urls and link counts are kept for each vertex, as in the graph of stream_vertices,
+    // with the stamp of every file as it is opened
+    Rep list = read_collection();
+    graph G = create_graph(list->size);
+    for (int i = 0; i < list->size; i++) add_vertex(G, list->items[i].str);
+    struct source_stamp* stamps = malloc(sizeof(struct source_stamp) * ((long)G->nV + 1));
+    assert(stamps);
+    stamps[0] = list->stamp;
+    free_rep(list);
+
+    // Parse every url file once, spilling its links to disk in sorted runs
+    // (loops are ignored and a url listed twice adds its links from its first vertex, as in load_graph)
+    int spill = open_temporary(file, ".spill");
+    edge_key* keys = malloc(sizeof(edge_key) * RUN_EDGES);
+    assert(keys);
+    struct run* runs = NULL;
+    int n_runs = 0;
+    int runs_cap = 0;
+    int count = 0;
+    for (int v = 0; v < G->nV; v++) {
+        UrlFile url = open_url_file(G->map[v]);
+        stamps[v + 1] = url->stamp;
+        int from = vertex_ID(G, G->map[v]);
+        for (int i = 0; i < url->n_links; i++) {
+            int to = vertex_ID(G, url->links[i].str);
+            if (to == -1) {
+                fprintf(stderr, "%s links to a url that is not in collection.txt\n", G->map[v]);
+                abort();
+            }
+            if (to == from) continue;
+            if (count == RUN_EDGES) {
+                add_run(spill, keys, count, &runs, &n_runs, &runs_cap);
+                count = 0;
+            }
+            keys[count++] = (edge_key)to << 32 | (unsigned)from;
+        }
+        close_url_file(url);
+    }
+    if (count > 0) add_run(spill, keys, count, &runs, &n_runs, &runs_cap);
+    free(keys);
+
+    // Merge the runs into in-edge order, counting the links of every vertex
+    int sorted = open_temporary(file, ".sorted");
+    long long edges = merge_runs(G, spill, runs, n_runs, sorted);
+    close(spill);
+    free(runs);
+    if (edges > INT_MAX) {
+        fprintf(stderr, "Too many links for an edge stream file\n");
+        abort();
+    }
+    G->nE = edges;
+
+    // Sum the inlinks and outlinks of the destinations of every vertex, as caclulate_weights does
+    double* sum_I = calloc(G->nV > 0 ? G->nV : 1, sizeof(double));
+    double* sum_O = calloc(G->nV > 0 ? G->nV : 1, sizeof(double));
+    edge_key* block = malloc(sizeof(edge_key) * MERGE_EDGES);
+    assert(sum_I && sum_O && block);
+    for (long long done = 0; done < edges; done += MERGE_EDGES) {
+        int size = edges - done < MERGE_EDGES ? edges - done : MERGE_EDGES;
+        read_fully(sorted, block, sizeof(edge_key) * (long)size, sizeof(edge_key) * done);
+        for (int i = 0; i < size; i++) {
+            int dest = block[i] >> 32;
+            int src = block[i] & 0xffffffff;
+            double value = G->links[dest].links_out;
+            sum_I[src] += G->links[dest].links_in;
+            sum_O[src] += value > 0 ? value : 0.5;
+        }
+    }
+
+    // Write the weighted edges in the merged order, then the link counts, urls and stamps
+    struct stream_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, STREAM_MAGIC, sizeof(header.magic));
+    header.nV = G->nV;
+    header.nE = G->nE;
+    for (int i = 0; i < G->nV; i++) header.names_size += strlen(G->map[i]) + 1;
+    FILE* output = fopen(file, "wb");
+    assert(output);
+    fwrite(&header, sizeof(header), 1, output);
+    fseek(output, STREAM_BLOCK, SEEK_SET);
+    struct stream_edge edge;
+    memset(&edge, 0, sizeof(edge));
+    for (long long done = 0; done < edges; done += MERGE_EDGES) {
+        int size = edges - done < MERGE_EDGES ? edges - done : MERGE_EDGES;
+        read_fully(sorted, block, sizeof(edge_key) * (long)size, sizeof(edge_key) * done);
+        for (int i = 0; i < size; i++) {
+            edge.dest = block[i] >> 32;
+            edge.src = block[i] & 0xffffffff;
+            edge.weight = edge_weight(G, sum_I, sum_O, edge.src, edge.dest);
+            fwrite(&edge, sizeof(edge), 1, output);
+        }
+    }
+    fwrite(G->links, sizeof(struct info), G->nV, output);
+    for (int i = 0; i < G->nV; i++) fwrite(G->map[i], 1, strlen(G->map[i]) + 1, output);
+    fwrite(stamps, sizeof(struct source_stamp), (long)G->nV + 1, output);
+    fclose(output);
+
+    close(sorted);
+    free(block);
+    free(sum_I);
+    free(sum_O);
+    free(stamps);
+    drop_graph(G);
+}
+
+//open an edge stream file for ranking
+edge_stream open_edge_stream(char* file, int check_sources) {
+    int fd = open(file, O_RDONLY);
+    if (fd == -1) return NULL;
+    struct stat info;
+    struct stream_header header;
+    if (fstat(fd, &info) != 0 || pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+        memcmp(header.magic, STREAM_MAGIC, sizeof(header.magic)) != 0 || header.nV < 0 || header.names_size < 0) {
+        close(fd);
+        return NULL;
+    }
+    long long expected = stamps_offset(header.nV, header.nE, header.names_size) +
+                         (long long)sizeof(struct source_stamp) * ((long long)header.nV + 1);
+    if (expected != (long long)info.st_size) {
+        close(fd);
+        return NULL;
+    }
+    if (check_sources && !stream_sources_unchanged(fd, header)) {
+        close(fd);
+        return NULL;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    edge_stream s = malloc(sizeof(struct _edge_stream));
+    assert(s);
+    s->fd = fd;
+    s->nV = header.nV;
+    s->nE = header.nE;
+    s->names_size = header.names_size;
+    return s;
+}
+
+//return a graph holding the urls and link counts of the stream but no edges, for writing the ranking
+graph stream_vertices(edge_stream s) {
+    char* names = malloc(s->names_size > 0 ? s->names_size : 1);
+    assert(names);
+    long long offset = links_offset(s->nE);
+    graph G = create_graph(s->nV);
+    read_fully(s->fd, G->links, sizeof(struct info) * (long)s->nV, offset);
+    read_fully(s->fd, names, s->names_size, offset + sizeof(struct info) * (long long)s->nV);
+    char* name = names;
+    for (int i = 0; i < s->nV; i++) {
+        add_vertex(G, name);
+        name += strlen(name) + 1;
+    }
+    free(names);
+    return G;
+}
+
+//calculate the Pagerank of every vertex, reading the edges from the file once per iteration
+double* stream_weights(edge_stream s, double damping_factor, double min_diff, int max_iterations, int* iterations) {
+    int size = s->nV;
+    double* new_rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    double* old_rank = malloc(sizeof(double) * (size > 0 ? size : 1));
+    struct stream_edge* block = NULL;
+    assert(new_rank && old_rank);
+    if (posix_memalign((void**)&block, 4096, STREAM_BLOCK) != 0) abort();
+    for (int i = 0; i < size; i++) old_rank[i] = new_rank[i] = 1.0/size;
+
+    long long total = sizeof(struct stream_edge) * (long long)s->nE;
+    double teleport = (1-damping_factor)/size;
+    int count = 0;
+    while (count < max_iterations) {
+        for (int i = 0; i < size; i++) new_rank[i] = teleport;
+
+        // Stream the edges one block at a time, asking for the next block before using this one
+        for (long long done = 0; done < total; done += STREAM_BLOCK) {
+            long length = total - done < STREAM_BLOCK ? total - done : STREAM_BLOCK;
+            read_fully(s->fd, block, length, STREAM_BLOCK + done);
+            if (done + length < total) posix_fadvise(s->fd, STREAM_BLOCK + done + length, STREAM_BLOCK, POSIX_FADV_WILLNEED);
+            int edges = length / sizeof(struct stream_edge);
+            for (int e = 0; e < edges; e++) {
+                new_rank[block[e].dest] += damping_factor*block[e].weight*old_rank[block[e].src];
+            }
+        }
+
+        double diff = 0;
+        for (int i = 0; i < size; i++) diff += fabs(old_rank[i]-new_rank[i]);
+        count++;
+        if (diff < min_diff || count == max_iterations) break;
+        double* temp = old_rank;
+        old_rank = new_rank;
+        new_rank = temp;
+    }
+
+    *iterations = count;
+    free(block);
+    free(old_rank);
+    return new_rank;
+}
+
+//close an edge stream file and free its memory
+void close_edge_stream(edge_stream s) {
+    close(s->fd);
+    free(s);
+}
@@ -0,0 +1,62 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "graph.h"
+
+//first bytes of an edge stream file
+#define STREAM_MAGIC "PREDGES2"
+
+//edge stream files are read in blocks of this many bytes, the edge section starts on a block boundary
+#define STREAM_BLOCK (8 << 20)
+
+//header of an edge stream file, padded to STREAM_BLOCK bytes and followed by
+//  struct stream_edge edges[nE]   in in-edge order: by destination, then by source
+//  struct info links[nV]
+//  char names[names_size]         the urls, each followed by '\0'
+//  struct source_stamp stamps[nV+1]   collection.txt, then the url file of each vertex
+//the file uses the byte order and type sizes of the machine that wrote it
+struct stream_header {
+    char magic[8];
+    int nV;
+    int nE;
+    long long names_size;
+};
+
+//one weighted edge of an edge stream file
+struct stream_edge {
+    int src;
+    int dest;
+    double weight;
+};
+
+//an open edge stream file
+typedef struct _edge_stream {
+    int fd;
+    int nV;
+    int nE;
+    long long names_size;
+} *edge_stream;
+
+//build an edge stream file from collection.txt and the url files without building the graph in
+//memory: the links are parsed in one pass and spilled to disk in sorted runs, which are merged into
+//in-edge order, then the link counts and weights are found in further passes over the merged edges
+//only the urls, link counts and sums of each vertex and one run of edges are kept in memory
+//the edges and weights are exactly those of read_input's graph; the temporary files sit next to 'file'
+void build_edge_stream(char* file);
+
+//open an edge stream file for ranking
+//returns NULL if the file is missing or is not an edge stream, or if 'check_sources' is set and
+//collection.txt or any url file has changed since the file was written
+edge_stream open_edge_stream(char* file, int check_sources);
+
+//return a graph holding the urls and link counts of the stream but no edges, for writing the ranking
+graph stream_vertices(edge_stream s);
+
+//calculate the Pagerank of every vertex, keeping only the rank vectors in memory and reading the
+//edges from the file once per iteration; iterates and stops exactly like generate_weights
+double* stream_weights(edge_stream s, double damping_factor, double min_diff, int max_iterations, int* iterations);
+
+//close an edge stream file and free its memory
+void close_edge_stream(edge_stream s);
+
+#endif
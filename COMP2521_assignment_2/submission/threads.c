@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include "threads.h"
+
+//the arguments handed to each started thread
+struct thread_start {
+    int id;
+    void (*task)(int id, void* arg);
+    void* arg;
+};
+
+
+
+//helper functions//
+
+
+//entry point of every started thread
+static void* thread_main(void* data) {
+    struct thread_start* start = data;
+    start->task(start->id, start->arg);
+    return NULL;
+}
+
+
+
+//barrier functions//
+
+
+//prepare a barrier for 'count' threads
+void barrier_init(barrier* b, int count) {
+    assert(count > 0);
+    pthread_mutex_init(&b->lock, NULL);
+    pthread_cond_init(&b->all_arrived, NULL);
+    b->count = count;
+    b->waiting = 0;
+    b->generation = 0;
+}
+
+//block until all 'count' threads have reached the barrier
+void barrier_wait(barrier* b) {
+    pthread_mutex_lock(&b->lock);
+    int generation = b->generation;
+    if (++b->waiting == b->count) {
+        b->waiting = 0;
+        b->generation++;
+        pthread_cond_broadcast(&b->all_arrived);
+    } else {
+        //the generation changes exactly once all threads have arrived, which also guards against spurious wakeups
+        while (generation == b->generation) pthread_cond_wait(&b->all_arrived, &b->lock);
+    }
+    pthread_mutex_unlock(&b->lock);
+}
+
+//free any resources held by the barrier
+void barrier_destroy(barrier* b) {
+    pthread_mutex_destroy(&b->lock);
+    pthread_cond_destroy(&b->all_arrived);
+}
+
+
+
+//thread functions//
+
+
+//run task(id, arg) on 'threads' threads with ids 0 .. threads-1 and wait for all of them to finish
+void run_threads(int threads, void (*task)(int id, void* arg), void* arg) {
+    if (threads < 1) threads = 1;
+    pthread_t* handles = malloc(sizeof(pthread_t) * threads);
+    struct thread_start* starts = malloc(sizeof(struct thread_start) * threads);
+    assert(handles && starts);
+
+    for (int i = 0; i < threads; i++) {
+        starts[i].id = i;
+        starts[i].task = task;
+        starts[i].arg = arg;
+    }
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&handles[i], NULL, thread_main, &starts[i]) != 0) {
+            fprintf(stderr, "Unable to start thread %d\n", i);
+            abort();
+        }
+    }
+    task(0, arg);
+    for (int i = 1; i < threads; i++) pthread_join(handles[i], NULL);
+
+    free(handles);
+    free(starts);
+}
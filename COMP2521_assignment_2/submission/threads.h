@@ -0,0 +1,29 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <pthread.h>
+
+//a reusable barrier, built on a mutex and condition variable since pthread_barrier_t is not
+//available on every platform
+typedef struct _barrier {
+    pthread_mutex_t lock;
+    pthread_cond_t all_arrived;
+    int count;
+    int waiting;
+    int generation;
+} barrier;
+
+//prepare a barrier for 'count' threads
+void barrier_init(barrier* b, int count);
+
+//block until all 'count' threads have reached the barrier
+void barrier_wait(barrier* b);
+
+//free any resources held by the barrier
+void barrier_destroy(barrier* b);
+
+//run task(id, arg) on 'threads' threads with ids 0 .. threads-1 and wait for all of them to finish
+//the calling thread runs id 0 itself
+void run_threads(int threads, void (*task)(int id, void* arg), void* arg);
+
+#endif